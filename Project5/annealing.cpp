@@ -0,0 +1,195 @@
+// File: annealing.cpp
+// Simulated annealing for the knapsack problem on a wall-clock budget.
+// A move picks a random item.  A selected item is dropped; an unselected item is added if it
+// fits, and otherwise swapped with one random selected item if that makes room (the cheap
+// repair), and rejected if not.  Every move is scored in O(1) from running cost and value totals.
+// A worsening move of delta is accepted with probability exp(delta / T), tested as
+// -delta <= T * -ln(u) with -ln(u) read from a precomputed table, so the inner loop never
+// calls exp() or log().  The temperature falls geometrically over the budget.
+
+#include <math.h>
+
+#include "annealing.h"
+#include "d_random.h"
+#include "searchstats.h"
+
+using namespace std;
+
+namespace
+{
+	const int tableBits = 12;
+	const int checkInterval = 1 << 16;
+
+	// xorshift64* generator, seeded from randomNumber; randomNumber itself is too slow for the inner loop
+	struct fastRandom
+	{
+		unsigned long long state;
+
+		unsigned long long next()
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1DULL;
+		}
+
+		int below(int n)
+		{
+			return (int)(((next() >> 32) * (unsigned long long)n) >> 32);
+		}
+	};
+}
+
+void simulatedAnnealing(knapsack &k, int time, long seed)
+// Anneal from the current contents of k for time seconds, and leave the best solution found in k.
+{
+	searchControl control((double)time);
+	simulatedAnnealing(k, control, seed);
+}
+
+void simulatedAnnealing(knapsack &k, searchControl &control, long seed, const knapsackCallback &onImprove)
+// Anneal from the current contents of k until control stops it, and leave the best solution
+// found in k.  The temperature schedule runs from now to the control's deadline.  onImprove,
+// if set, is called at the periodic checks with the best solution, when it has improved since
+// the previous call.
+{
+	int numObjects = k.getNumObjects();
+	int costLimit = k.getCostLimit();
+	if (numObjects == 0)
+		return;
+
+	vector<int> cost(numObjects);
+	vector<int> value(numObjects);
+	int maxValue = 1;
+	for (int i = 0; i < numObjects; i++)
+	{
+		cost[i] = k.getCost(i);
+		value[i] = k.getValue(i);
+		maxValue = max(maxValue, value[i]);
+	}
+
+	// -ln(u) for u evenly spread over (0, 1)
+	vector<float> negLog(1 << tableBits);
+	for (int i = 0; i < (int)negLog.size(); i++)
+		negLog[i] = (float)-log((i + 0.5) / negLog.size());
+
+	// Selected items, with each item's place in the list for O(1) removal
+	Solution current = k.getSelected();
+	vector<int> selectedList;
+	vector<int> place(numObjects, -1);
+	for (int i = current.first(); i != -1; i = current.next(i))
+	{
+		place[i] = (int)selectedList.size();
+		selectedList.push_back(i);
+	}
+
+	int currentCost = k.getCost();
+	int currentValue = k.getValue();
+	Solution best = current;
+	int bestValue = currentValue;
+	bool atBest = true;
+
+	randomNumber seeder(seed);
+	fastRandom random;
+	random.state = ((unsigned long long)seeder.random() << 32) ^ (unsigned long long)seeder.random() ^ 0x9E3779B97F4A7C15ULL;
+
+	double startTemperature = maxValue / 4.0;
+	double endTemperature = 0.5;
+	double temperature = startTemperature;
+	int reportedValue = bestValue;
+
+	for (long long moves = 1; ; moves++)
+	{
+		if (moves % checkInterval == 0)
+		{
+			STAT_ADD(iterations, checkInterval);
+			STAT_ADD(neighborsEvaluated, checkInterval);
+
+			if (onImprove && bestValue > reportedValue)
+			{
+				if (atBest)
+					best = current;
+				onImprove(bestValue, best);
+				reportedValue = bestValue;
+			}
+
+			if (control.checkNow())
+				break;
+
+			temperature = startTemperature * pow(endTemperature / startTemperature, control.fractionElapsed());
+		}
+
+		int item = random.below(numObjects);
+		int out = -1;
+		int in = -1;
+		int delta;
+
+		if (current.test(item))
+		{
+			out = item;
+			delta = -value[item];
+		}
+		else if (currentCost + cost[item] <= costLimit)
+		{
+			in = item;
+			delta = value[item];
+		}
+		else
+		{
+			if (selectedList.empty())
+				continue;
+
+			out = selectedList[random.below((int)selectedList.size())];
+			if (currentCost - cost[out] + cost[item] > costLimit)
+				continue;
+
+			in = item;
+			delta = value[item] - value[out];
+		}
+
+		if (delta < 0)
+		{
+			if (-delta > temperature * negLog[random.next() >> (64 - tableBits)])
+				continue;
+
+			// Leaving the best solution, so remember it first
+			if (atBest)
+			{
+				best = current;
+				atBest = false;
+			}
+		}
+
+		if (out != -1)
+		{
+			current.reset(out);
+			currentCost -= cost[out];
+			int last = selectedList.back();
+			selectedList[place[out]] = last;
+			place[last] = place[out];
+			selectedList.pop_back();
+			place[out] = -1;
+		}
+
+		if (in != -1)
+		{
+			current.set(in);
+			currentCost += cost[in];
+			place[in] = (int)selectedList.size();
+			selectedList.push_back(in);
+		}
+
+		currentValue += delta;
+		if (currentValue > bestValue)
+		{
+			bestValue = currentValue;
+			atBest = true;
+			STAT_INCUMBENT(bestValue);
+		}
+	}
+
+	if (atBest)
+		best = current;
+
+	k.setItems(best);
+}
@@ -0,0 +1,9 @@
+// Simulated annealing for the knapsack problem
+#pragma once
+
+#include "anytime.h"
+#include "knapsack.h"
+
+void simulatedAnnealing(knapsack &k, int time, long seed = 1);
+void simulatedAnnealing(knapsack &k, searchControl &control, long seed = 1,
+	const knapsackCallback &onImprove = knapsackCallback());
@@ -0,0 +1,77 @@
+// File: anytime.cpp
+// Deadlines and cancellation for the anytime solvers.
+
+#include <algorithm>
+
+#include "anytime.h"
+
+cancellationToken::cancellationToken() : cancelled(false)
+{
+}
+
+void cancellationToken::cancel()
+{
+	cancelled.store(true, memory_order_relaxed);
+}
+
+bool cancellationToken::isCancelled() const
+{
+	return cancelled.load(memory_order_relaxed);
+}
+
+searchControl::searchControl(double seconds, const cancellationToken *token, int checkInterval)
+// Stop seconds from now, or when token is cancelled.
+	: start(chrono::steady_clock::now()), token(token), checkInterval(max(1, checkInterval)),
+	untilCheck(max(1, checkInterval)), isStopped(false)
+{
+	deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+}
+
+searchControl::searchControl(chrono::steady_clock::time_point deadline, const cancellationToken *token, int checkInterval)
+// Stop at deadline, or when token is cancelled.
+	: start(chrono::steady_clock::now()), deadline(deadline), token(token),
+	checkInterval(max(1, checkInterval)), untilCheck(max(1, checkInterval)), isStopped(false)
+{
+}
+
+bool searchControl::checkNow()
+// Read the clock and the token now, and return whether the search should stop.
+{
+	if (!isStopped)
+		isStopped = (token != NULL && token->isCancelled()) || chrono::steady_clock::now() >= deadline;
+
+	return isStopped;
+}
+
+double searchControl::elapsed() const
+// Return the seconds since this control was made.
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double searchControl::fractionElapsed() const
+// Return how much of the time from construction to the deadline has passed, from 0 to 1.
+{
+	double total = chrono::duration<double>(deadline - start).count();
+	if (total <= 0)
+		return 1;
+
+	return min(1.0, elapsed() / total);
+}
+
+chrono::steady_clock::time_point searchControl::getDeadline() const
+{
+	return deadline;
+}
+
+long streamSeed(long seed, int stream)
+// Return the seed of a stream, mixed from the run's seed and the stream number.
+// randomNumber needs a seed in 1..2^31-2 (0 would seed it from the clock).
+{
+	unsigned long long z = (unsigned long long)seed * 0x9E3779B97F4A7C15ULL + (unsigned long long)(stream + 1) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+
+	return 1 + (long)(z % 2147483646ULL);
+}
@@ -0,0 +1,66 @@
+// Deadlines, cancellation and incumbent callbacks for the anytime solvers
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include "solution.h"
+
+using namespace std;
+
+// Set from any thread to ask a running solver to stop and return its incumbent.
+class cancellationToken
+{
+public:
+	cancellationToken();
+	void cancel();
+	bool isCancelled() const;
+
+private:
+	atomic<bool> cancelled;
+};
+
+// When a solver should stop: at a steady-clock deadline, or when a token is cancelled.
+// stopped() reads the clock and the token only once every checkInterval calls, so it is
+// cheap enough to call once per node or move.  Once it returns true it keeps returning true.
+// Each thread of a parallel solver works on its own copy.
+class searchControl
+{
+public:
+	explicit searchControl(double seconds, const cancellationToken *token = NULL, int checkInterval = 1024);
+	explicit searchControl(chrono::steady_clock::time_point deadline, const cancellationToken *token = NULL, int checkInterval = 1024);
+	bool stopped();
+	bool checkNow();
+	double elapsed() const;
+	double fractionElapsed() const;
+	chrono::steady_clock::time_point getDeadline() const;
+
+private:
+	chrono::steady_clock::time_point start;
+	chrono::steady_clock::time_point deadline;
+	const cancellationToken *token;
+	int checkInterval;
+	int untilCheck;
+	bool isStopped;
+};
+
+inline bool searchControl::stopped()
+{
+	if (isStopped)
+		return true;
+
+	if (--untilCheck > 0)
+		return false;
+
+	untilCheck = checkInterval;
+	return checkNow();
+}
+
+// Parallel solvers give each start or worker its own randomNumber stream, seeded by this from
+// the run's seed and the stream number, so that a run depends only on its seed.
+long streamSeed(long seed, int stream);
+
+// Called with the value and items of each new knapsack incumbent.  Parallel solvers may call
+// it from any of their threads, but never from two at once.
+typedef function<void(int value, const Solution &items)> knapsackCallback;
@@ -0,0 +1,194 @@
+#include "bbnode.h"
+#include "searchstats.h"
+
+decisionTrail::decisionTrail()
+{
+	freeEntry = none;
+	numEntries = 0;
+}
+
+int decisionTrail::take(int parent, int item)
+// Record that item is taken after the decisions in parent, and return the new entry.
+// The caller owns one reference to the new entry.
+{
+	int entry;
+
+	if (freeEntry != none)
+	{
+		entry = freeEntry;
+		freeEntry = decisions[entry].parent;
+	}
+	else
+	{
+		entry = (int)decisions.size();
+		decisions.push_back(decision());
+	}
+
+	decisions[entry].parent = parent;
+	decisions[entry].item = item;
+	decisions[entry].refs = 1;
+	retain(parent);
+	numEntries++;
+
+	return entry;
+}
+
+void decisionTrail::retain(int entry)
+// Add a reference to entry (a new node or decision that shares it).
+{
+	if (entry != none)
+		decisions[entry].refs++;
+}
+
+void decisionTrail::release(int entry)
+// Drop a reference to entry, recycling it and then its parents as they become unreachable.
+{
+	while (entry != none && --decisions[entry].refs == 0)
+	{
+		int parent = decisions[entry].parent;
+
+		decisions[entry].parent = freeEntry;
+		freeEntry = entry;
+		numEntries--;
+
+		entry = parent;
+	}
+}
+
+void decisionTrail::getItems(int entry, vector<int> &items) const
+// Fill items with every item taken on the way to entry.
+{
+	items.clear();
+
+	for (; entry != none; entry = decisions[entry].parent)
+		items.push_back(decisions[entry].item);
+}
+
+int decisionTrail::getNumEntries() const
+// Return the number of entries in use.
+{
+	return numEntries;
+}
+
+dominanceTable::dominanceTable(size_t bytes)
+// Make a table of the largest power of two number of slots that fits in bytes, and at least one.
+{
+	size_t numSlots = 1;
+	while (numSlots * 2 * sizeof(entry) <= bytes)
+		numSlots *= 2;
+
+	entry empty = { 0, 0 };
+	slots.assign(numSlots, empty);
+	mask = numSlots - 1;
+	stats.probes = 0;
+	stats.hits = 0;
+	stats.prunes = 0;
+}
+
+bool dominanceTable::dominated(const bbNode &node)
+// Return true if a node of the same state with at least node's value has been recorded, and
+// record node otherwise.
+{
+	unsigned long long key = ((unsigned long long)(node.depth + 1) << 32) | (unsigned int)node.cost;
+
+	// splitmix64 finalizer
+	unsigned long long h = key;
+	h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+
+	entry &slot = slots[h & mask];
+	stats.probes++;
+	STAT_ADD(dominanceProbes, 1);
+
+	if (slot.key == key)
+	{
+		stats.hits++;
+		STAT_ADD(dominanceHits, 1);
+
+		if (slot.value >= node.value)
+		{
+			stats.prunes++;
+			STAT_ADD(dominancePrunes, 1);
+			return true;
+		}
+	}
+
+	slot.key = key;
+	slot.value = node.value;
+	return false;
+}
+
+const dominanceStats &dominanceTable::getStats() const
+{
+	return stats;
+}
+
+bool isFathomed(const knapsack &k, const bbNode &node, int incumbentValue)
+// Node is fathomed if the incumbent is at least its bound, all items have been
+// considered, or no more items can fit in the knapsack
+{
+	if (node.bound <= incumbentValue)
+	{
+		STAT_ADD(prunedByBound, 1);
+		return true;
+	}
+
+	if (node.depth == k.getNumObjects())
+	{
+		STAT_ADD(leavesReached, 1);
+		return true;
+	}
+
+	if (k.getMinCost(node.depth) > k.getCostLimit() - node.cost)
+	{
+		STAT_ADD(prunedByFeasibility, 1);
+		return true;
+	}
+
+	return false;
+}
+
+int branch(const knapsack &k, const vector<int> &items, decisionTrail &trail, const bbNode &node, int incumbentValue,
+	bbNode children[2], boundType type)
+// Branch on the next item in the density order: one child takes it, one skips it.
+// The children are bounded with the given bound type.
+// Children that cannot beat the incumbent are dropped.  The rest are written to children
+// with the better bound last, so that a stack explores it first, and their count is returned.
+// Each child owns a reference to its trail; node keeps its own.
+{
+	int item = items[node.depth];
+	int numChildren = 0;
+
+	bbNode no = { node.depth + 1, node.cost, node.value, 0, node.trail };
+	no.bound = k.bound(no.depth, no.cost, no.value, type);
+	bool keepNo = no.bound > incumbentValue;
+
+	if (keepNo)
+	{
+		trail.retain(no.trail);
+		children[numChildren++] = no;
+	}
+	else
+		STAT_ADD(prunedByBound, 1);
+
+	if (node.cost + k.getCost(item) <= k.getCostLimit())
+	{
+		bbNode yes = { node.depth + 1, node.cost + k.getCost(item), node.value + k.getValue(item), 0, 0 };
+		yes.bound = k.bound(yes.depth, yes.cost, yes.value, type);
+		yes.trail = trail.take(node.trail, item);
+
+		if (keepNo && yes.bound < no.bound)
+		{
+			children[1] = children[0];
+			children[0] = yes;
+			numChildren++;
+		}
+		else
+			children[numChildren++] = yes;
+	}
+	else
+		STAT_ADD(prunedByFeasibility, 1);
+
+	return numChildren;
+}
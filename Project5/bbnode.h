@@ -0,0 +1,104 @@
+// Branch and bound node and decision trail classes
+#pragma once
+
+#include <vector>
+
+#include "knapsack.h"
+
+using namespace std;
+
+// A branch and bound node.  Items before depth in the density order have been decided,
+// and cost and value are the totals of the items taken so far.  The items themselves
+// are kept in a decisionTrail shared by every node of the search.
+struct bbNode
+{
+	int depth;
+	int cost;
+	int value;
+	int bound;			// an integer no smaller than the value of any completion
+	int trail;
+};
+
+// Order in which branch and bound explores open nodes.  hybrid dives depth first until it has
+// an incumbent and then explores best bound first.
+enum bbStrategy { depthFirst, bestFirst, hybrid };
+
+// Depth above which branch and bound uses its stronger bound by default, falling back to the
+// Dantzig bound below it.  Deeper nodes are many and their subtrees small, so the extra cost of
+// the stronger bound pays off less there.
+const int defaultBoundDepth = 32;
+
+// Orders a priority queue of nodes by bound, breaking ties in favor of deeper nodes
+struct bbNodeLess
+{
+	bool operator()(const bbNode &a, const bbNode &b) const
+	{
+		return a.bound < b.bound || (a.bound == b.bound && a.depth < b.depth);
+	}
+};
+
+// Shared, reference counted record of the "take" decisions of open nodes.
+// Each entry holds one item taken and the entry for the previous item taken, so a node's
+// solution is the chain of entries from its trail back to the root.  Skipping an item
+// adds no entry, and entries are recycled once no node can reach them.
+class decisionTrail
+{
+public:
+	static const int none = -1;
+
+	decisionTrail();
+	int take(int parent, int item);
+	void retain(int entry);
+	void release(int entry);
+	void getItems(int entry, vector<int> &items) const;
+	int getNumEntries() const;
+
+private:
+	struct decision
+	{
+		int parent;
+		int item;
+		int refs;
+	};
+
+	vector<decision> decisions;
+	int freeEntry;
+	int numEntries;
+};
+
+// What a dominanceTable did over a search: the nodes looked up, the lookups that found a node of
+// the same state, and the lookups that pruned their node
+struct dominanceStats
+{
+	long long probes;
+	long long hits;
+	long long prunes;
+};
+
+// Lossy table of the best value seen at each (depth, cost) state of a branch and bound search.
+// Nodes at the same depth with the same cost have the same subproblem ahead of them, so a node
+// is dominated once a node of that state with at least its value has been expanded.  Each state
+// maps to one slot and a newer state overwrites an older one, so the table only ever forgets
+// states.  Each search, or each worker of a parallel search, owns its own table.
+class dominanceTable
+{
+public:
+	dominanceTable(size_t bytes);
+	bool dominated(const bbNode &node);
+	const dominanceStats &getStats() const;
+
+private:
+	struct entry
+	{
+		unsigned long long key;
+		int value;
+	};
+
+	vector<entry> slots;
+	size_t mask;
+	dominanceStats stats;
+};
+
+bool isFathomed(const knapsack &k, const bbNode &node, int incumbentValue);
+int branch(const knapsack &k, const vector<int> &items, decisionTrail &trail, const bbNode &node, int incumbentValue,
+	bbNode children[2], boundType type = dantzigBound);
@@ -0,0 +1,234 @@
+// File: benchmark.cpp
+// Runs the knapsack solvers on generated instances of every class, from 100 items up to
+// maxItems by factors of ten, and writes one CSV row per run:
+//   class,items,costLimit,solver,seconds,peakKB,value,bound,gap
+// bound is the LP bound of the instance, rounded down, so gap = (bound - value) / bound is an upper bound on
+// the true optimality gap.  peakKB is the peak resident set of the whole process so far, so a
+// row only shows a solver's own footprint once it exceeds everything that ran before it.
+// Solvers without a time limit are skipped on instances too large for them to finish.
+
+#include <chrono>
+#include <math.h>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "benchmark.h"
+#include "d_random.h"
+#include "generator.h"
+#include "p5a.h"
+
+using namespace std;
+
+namespace
+{
+	long long peakMemory()
+	// Return the peak resident set size of this process in kilobytes.
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+		return (long long)counters.PeakWorkingSetSize / 1024;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+#ifdef __APPLE__
+		return (long long)usage.ru_maxrss / 1024;
+#else
+		return (long long)usage.ru_maxrss;
+#endif
+#endif
+	}
+
+	double lpBound(const knapsack &k)
+	// Return the LP (Dantzig) bound of k in double precision; knapsack::bound rounds it down.
+	{
+		const vector<int> &order = k.sort();
+		double room = k.getCostLimit();
+		double bound = 0;
+
+		for (int i = 0; i < k.getNumObjects() && room > 0; i++)
+		{
+			int item = order[i];
+			if (k.getCost(item) <= room)
+			{
+				room -= k.getCost(item);
+				bound += k.getValue(item);
+			}
+			else
+			{
+				bound += room * k.getValue(item) / k.getCost(item);
+				room = 0;
+			}
+		}
+
+		return bound;
+	}
+
+	int numThreads()
+	{
+		return max(1, (int)thread::hardware_concurrency());
+	}
+
+	void runGreedy(knapsack &k, int /*time*/) { greedyKnapsack(k); }
+	void runBranchAndBound(knapsack &k, int time) { branchAndBound(k, time); }
+	void runDantzigBranchAndBound(knapsack &k, int time) { branchAndBound(k, time, depthFirst, 1 << 22, dantzigBound); }
+	void runEnumerativeBranchAndBound(knapsack &k, int time) { branchAndBound(k, time, depthFirst, 1 << 22, enumerativeBound); }
+	void runDominanceBranchAndBound(knapsack &k, int time)
+	// Dominance table of 4 KB per item, up to 64 MB
+	{
+		branchAndBound(k, time, depthFirst, 1 << 22, martelloTothBound, defaultBoundDepth, min((size_t)1 << 26, (size_t)k.getNumObjects() << 12));
+	}
+	void runReducedBranchAndBound(knapsack &k, int time) { reduceAndSolve(k, [time](knapsack &r) { branchAndBound(r, time); }); }
+	void runParallelBranchAndBound(knapsack &k, int time) { parallelBranchAndBound(k, time, numThreads()); }
+	void runExact(knapsack &k, int time) { exactKnapsack(k, time, 1LL << 30); }
+	void runCore(knapsack &k, int /*time*/) { coreKnapsack(k); }
+	void runFptas(knapsack &k, int /*time*/) { fptasKnapsack(k, 0.05); }
+	void runSteepestDescent(knapsack &k, int /*time*/) { steepestDescent(k); }
+	void runTabuSearch(knapsack &k, int time) { tabuSearch(k, time); }
+	void runAnnealing(knapsack &k, int time) { simulatedAnnealing(k, time, 1); }
+	void runMultiStart(knapsack &k, int /*time*/) { multiStartSearch(k, 64, numThreads(), 1); }
+
+	struct benchmarkSolver
+	{
+		const char *name;
+		void (*run)(knapsack &k, int time);
+		int maxItems;	// largest instance the solver is run on
+		bool exact;		// returns an optimal solution when it finishes in time
+	};
+
+	const benchmarkSolver solvers[] =
+	{
+		{ "greedyKnapsack", runGreedy, INT_MAX, false },
+		{ "branchAndBound", runBranchAndBound, INT_MAX, true },
+		{ "branchAndBoundDantzig", runDantzigBranchAndBound, INT_MAX, true },
+		{ "branchAndBoundEnumerative", runEnumerativeBranchAndBound, INT_MAX, true },
+		{ "branchAndBoundDominance", runDominanceBranchAndBound, INT_MAX, true },
+		{ "reducedBranchAndBound", runReducedBranchAndBound, INT_MAX, true },
+		{ "parallelBranchAndBound", runParallelBranchAndBound, INT_MAX, true },
+		{ "exactKnapsack", runExact, INT_MAX, true },
+		{ "coreKnapsack", runCore, 100000, true },
+		{ "fptasKnapsack", runFptas, 10000, false },
+		{ "steepestDescent", runSteepestDescent, 10000, false },
+		{ "tabuSearch", runTabuSearch, INT_MAX, false },
+		{ "simulatedAnnealing", runAnnealing, INT_MAX, false },
+		{ "multiStartSearch", runMultiStart, 10000, false },
+	};
+}
+
+void checkExactSolvers(int numInstances, long seed)
+// Run every exact solver on numInstances small instances, spread over the instance classes,
+// and throw a rangeError if one finds a value other than exactKnapsack's.  Small data ranges
+// give many ties in density, where bounds are most easily off by one.  Every other instance
+// has its values scaled by 2^20 with a little noise, so that the ties become near ties among
+// values in the tens of millions, as large benchmark instances have, while the costs stay
+// small enough for exactKnapsack to solve by dynamic programming.
+{
+	for (int i = 0; i < numInstances; i++)
+	{
+		knapsackData data;
+		generateKnapsack(data, (instanceClass)(i % numInstanceClasses), 2 + i % 39, 10 + i % 31, seed + i);
+
+		if (i % 2 == 1)
+		{
+			randomNumber random(seed + i);
+			for (int j = 0; j < data.numObjects; j++)
+				data.value[j] = (data.value[j] << 20) + (int)random.random(1024);
+		}
+
+		knapsack reference(data);
+		exactKnapsack(reference, 10);
+
+		for (int s = 0; s < (int)(sizeof(solvers) / sizeof(solvers[0])); s++)
+		{
+			if (!solvers[s].exact)
+				continue;
+
+			knapsack k(data);
+			solvers[s].run(k, 10);
+
+			if (k.getCost() > k.getCostLimit() || k.getValue() != reference.getValue())
+				throw rangeError(string(solvers[s].name) + " is not optimal on check instance " + to_string(i) +
+					" of seed " + to_string(seed));
+		}
+	}
+}
+
+void knapsackBenchmark(const string &csvFile, int maxItems, int time, long seed)
+// Benchmark every solver on every instance class, giving each run time seconds where the solver
+// takes a time limit, and write the results to csvFile.  The exact solvers are checked first.
+{
+	ofstream fout(csvFile.c_str());
+	if (!fout)
+		throw fileOpenError(csvFile);
+
+	checkExactSolvers(1000, seed);
+
+	fout << "class,items,costLimit,solver,seconds,peakKB,value,bound,gap" << endl;
+
+	for (long long n = 100; n <= maxItems; n *= 10)
+	{
+		for (int c = 0; c < numInstanceClasses; c++)
+		{
+			instanceClass type = (instanceClass)c;
+			knapsackData data;
+			generateKnapsack(data, type, (int)n, defaultRange((int)n), seed);
+
+			for (int s = 0; s < (int)(sizeof(solvers) / sizeof(solvers[0])); s++)
+			{
+				if (n > solvers[s].maxItems)
+					continue;
+
+				knapsack k(data);
+				double bound = lpBound(k);
+
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				solvers[s].run(k, time);
+				double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+				if (k.getCost() > k.getCostLimit())
+					throw rangeError(string(solvers[s].name) + " returned an infeasible solution");
+
+				bound = floor(bound);
+				double gap = bound > 0 ? (bound - k.getValue()) / bound : 0;
+				fout << instanceClassName(type) << "," << n << "," << data.costLimit << ","
+					<< solvers[s].name << "," << seconds << "," << peakMemory() << ","
+					<< k.getValue() << "," << (long long)bound << "," << gap << endl;
+
+				cout << instanceClassName(type) << " " << n << " " << solvers[s].name << ": "
+					<< k.getValue() << " in " << seconds << "s" << endl;
+			}
+		}
+	}
+}
+
+void benchmarkRun()
+// Ask for the largest instance size and the time limit, and run the knapsack benchmark.
+{
+	int maxItems, time;
+
+	cout << "Largest instance size (items): ";
+	cin >> maxItems;
+	cout << "Time limit per run (seconds): ";
+	cin >> time;
+
+	try
+	{
+		knapsackBenchmark("knapsack/output/benchmark.csv", maxItems, time, 1);
+		cout << "Results written to knapsack/output/benchmark.csv" << endl;
+	}
+	catch (baseException &ex)
+	{
+		cerr << ex.what() << endl;
+	}
+}
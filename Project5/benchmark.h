@@ -0,0 +1,10 @@
+// Knapsack scaling benchmark
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+void checkExactSolvers(int numInstances, long seed);
+void knapsackBenchmark(const string &csvFile, int maxItems, int time, long seed);
+void benchmarkRun();
@@ -0,0 +1,132 @@
+// File: conflicttable.cpp
+// Maintains the node by color conflict table.  Recoloring v from a to b moves v's contribution
+// from column a to column b in the row of each neighbor, changes the conflict count by
+// delta(v, b), and can only change whether v and its neighbors are in conflict.
+
+#include "conflicttable.h"
+
+using namespace std;
+
+conflictTable::conflictTable(const csrGraph &g, int numColors)
+// Construct a table for colorings of g with numColors colors, starting with every node color 0.
+	: g(&g), numColors(numColors)
+{
+	if (numColors < 1 || numColors > maxColors)
+		throw rangeError("Bad number of colors in conflictTable::conflictTable");
+
+	selfLoops.assign(g.getNumNodes(), 0);
+	for (int v = 0; v < g.getNumNodes(); v++)
+		for (const int *u = g.adjacentBegin(v); u != g.adjacentEnd(v); ++u)
+			if (*u == v)
+				selfLoops[v]++;
+
+	reset(coloring(g.getNumNodes(), 0));
+}
+
+void conflictTable::reset(const coloring &colors)
+// Set the coloring to colors and rebuild the table, in O(Vk + E) time.
+{
+	int n = g->getNumNodes();
+	if ((int)colors.size() != n)
+		throw rangeError("Bad coloring size in conflictTable::reset");
+
+	this->colors = colors;
+	table.assign((size_t)n * numColors, 0);
+	numConflicts = 0;
+
+	for (int v = 0; v < n; v++)
+	{
+		if (colors[v] >= numColors)
+			throw rangeError("Bad color in conflictTable::reset");
+
+		int *row = &table[(size_t)v * numColors];
+		for (const int *u = g->adjacentBegin(v); u != g->adjacentEnd(v); ++u)
+		{
+			row[colors[*u]]++;
+			if (*u >= v && colors[*u] == colors[v])
+				numConflicts++;
+		}
+	}
+
+	conflicting.clear();
+	position.assign(n, -1);
+	for (int v = 0; v < n; v++)
+		updateConflicting(v);
+}
+
+void conflictTable::recolor(int v, int color)
+// Give v the given color, in O(deg(v)) time.
+{
+	int old = colors[v];
+	if (color == old)
+		return;
+
+	numConflicts += delta(v, color);
+	colors[v] = (unsigned short)color;
+
+	for (const int *u = g->adjacentBegin(v); u != g->adjacentEnd(v); ++u)
+	{
+		int *row = &table[(size_t)*u * numColors];
+		row[old]--;
+		row[color]++;
+		updateConflicting(*u);
+	}
+
+	updateConflicting(v);
+}
+
+void conflictTable::updateConflicting(int v)
+// Add v to or remove it from the list of nodes in conflict, as its row says.
+{
+	bool inConflict = count(v, colors[v]) > 0;
+
+	if (inConflict && position[v] < 0)
+	{
+		position[v] = (int)conflicting.size();
+		conflicting.push_back(v);
+	}
+	else if (!inConflict && position[v] >= 0)
+	{
+		int last = conflicting.back();
+		conflicting[position[v]] = last;
+		position[last] = position[v];
+		conflicting.pop_back();
+		position[v] = -1;
+	}
+}
+
+int conflictTable::getNumColors() const
+// Return the number of colors.
+{
+	return numColors;
+}
+
+int conflictTable::getNumConflicts() const
+// Return the number of edges whose ends have the same color.
+{
+	return numConflicts;
+}
+
+const coloring &conflictTable::getColors() const
+// Return the coloring.
+{
+	return colors;
+}
+
+int conflictTable::getColor(int v) const
+// Return the color of v.
+{
+	return colors[v];
+}
+
+int conflictTable::getNumConflicting() const
+// Return the number of nodes with a neighbor of their own color.
+{
+	return (int)conflicting.size();
+}
+
+int conflictTable::getConflicting(int i) const
+// Return the i-th node with a neighbor of its own color.
+{
+	return conflicting[i];
+}
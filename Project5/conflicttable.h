@@ -0,0 +1,60 @@
+// Incremental conflict bookkeeping for the coloring solvers
+#pragma once
+
+#include "csrgraph.h"
+
+// A coloring of a graph together with, for every node v and color c, the number of neighbors of v
+// that have color c.  From the table any recolor is scored in O(1) and applied in O(deg(v)), and
+// the conflict count and the set of nodes in conflict are kept up to date as it is applied.
+class conflictTable
+{
+public:
+	conflictTable(const csrGraph &g, int numColors);
+	void reset(const coloring &colors);
+	int getNumColors() const;
+	int getNumConflicts() const;
+	const coloring &getColors() const;
+	int getColor(int v) const;
+	int count(int v, int color) const;
+	int delta(int v, int color) const;
+	void recolor(int v, int color);
+	int getNumConflicting() const;
+	int getConflicting(int i) const;
+	bool isConflicting(int v) const;
+
+private:
+	const csrGraph *g;
+	int numColors;
+	coloring colors;
+	vector<int> table;			// table[v * numColors + c]
+	vector<int> selfLoops;
+	int numConflicts;
+
+	// Nodes with a neighbor of their own color, in no particular order, and each node's
+	// position in that list or -1
+	vector<int> conflicting;
+	vector<int> position;
+
+	void updateConflicting(int v);
+};
+
+inline int conflictTable::count(int v, int color) const
+// Return the number of neighbors of v with the given color.
+{
+	return table[(size_t)v * numColors + color];
+}
+
+inline int conflictTable::delta(int v, int color) const
+// Return the change in the number of conflicts if v were given color.
+{
+	if (color == colors[v])
+		return 0;
+
+	return count(v, color) + selfLoops[v] - count(v, colors[v]);
+}
+
+inline bool conflictTable::isConflicting(int v) const
+// Return true if v has a neighbor of its own color.
+{
+	return position[v] >= 0;
+}
@@ -0,0 +1,192 @@
+// File: coreknapsack.cpp
+// Exact knapsack by an expanding core, in the style of Pisinger's minknap.
+// The greedy break solution takes every item before the break item in the density order.
+// The search starts from that solution and widens a core of items around the break item one item
+// at a time, alternating between the next item to the right, which may be added, and the next item
+// to the left, which may be removed.  Items outside the core keep their break solution value.
+// The reachable solutions are kept as a list of (cost, value) states with dominated states removed,
+// and a state is dropped as soon as its bound says that no item outside the core can lift it above
+// the incumbent.  The search ends when no state is left, which usually happens while the core is
+// still a small fraction of the items.
+
+#include <algorithm>
+
+#include "bbnode.h"
+#include "coreknapsack.h"
+
+using namespace std;
+
+namespace
+{
+	struct coreState
+	{
+		int cost;
+		int value;
+		int trail;  // items whose value differs from the break solution
+	};
+
+	struct coreSearch
+	{
+		const knapsack *k;
+		vector<int> items;
+		decisionTrail trail;
+		vector<coreState> states;
+		vector<coreState> merged;
+		vector<int> dropped;
+
+		int incumbentValue;
+		int incumbentTrail;
+	};
+
+	bool canImprove(const coreSearch &search, const coreState &state, int left, int right)
+	// Bound a state: items left of position left and right of position right have not entered the core.
+	// An overfull state must shed its excess at a density of at least that of item left, and a
+	// state with room to spare can fill it at a density of at most that of item right.
+	// The bound is compared with the incumbent in integers, multiplied through by the cost of
+	// that item, since a rounded density can put a bound of exactly incumbent + 1 just below it.
+	{
+		const knapsack &k = *search.k;
+		long long target = (long long)search.incumbentValue + 1;
+
+		if (state.cost > k.getCostLimit())
+		{
+			if (left < 0)
+				return false;
+
+			int item = search.items[left];
+			long long excess = (long long)state.cost - k.getCostLimit();
+			return (long long)state.value * k.getCost(item) - excess * k.getValue(item) >= target * k.getCost(item);
+		}
+		else if (right < k.getNumObjects())
+		{
+			int item = search.items[right];
+			long long room = (long long)k.getCostLimit() - state.cost;
+			return (long long)state.value * k.getCost(item) + room * k.getValue(item) >= target * k.getCost(item);
+		}
+
+		return state.value >= target;
+	}
+
+	void addItem(coreSearch &search, int item, int sign, int left, int right)
+	// Let item into the core, where sign is 1 if the break solution skips it and -1 if it takes it.
+	// Every state splits in two (item flipped or not), and the two lists, both sorted by cost,
+	// are merged while dropping dominated states and states that cannot beat the incumbent.
+	{
+		const knapsack &k = *search.k;
+		vector<coreState> &states = search.states;
+		vector<coreState> &merged = search.merged;
+		int cost = sign * k.getCost(item);
+		int value = sign * k.getValue(item);
+		int numStates = (int)states.size();
+		int i = 0;
+		int j = 0;
+
+		merged.clear();
+		search.dropped.clear();
+
+		while (i < numStates || j < numStates)
+		{
+			coreState state;
+			bool flipped = i == numStates || (j < numStates && states[j].cost + cost < states[i].cost);
+
+			if (flipped)
+			{
+				state.cost = states[j].cost + cost;
+				state.value = states[j].value + value;
+				state.trail = states[j].trail;
+				j++;
+			}
+			else
+				state = states[i++];
+
+			// Drop states that weigh more than the last state kept but are worth no more.
+			// The flipped copy of a dropped state may still be kept, so its trail is released at the end.
+			if ((!merged.empty() && state.value <= merged.back().value) || !canImprove(search, state, left, right))
+			{
+				if (!flipped)
+					search.dropped.push_back(state.trail);
+				continue;
+			}
+
+			if (flipped)
+				state.trail = search.trail.take(state.trail, item);
+
+			if (state.cost <= k.getCostLimit() && state.value > search.incumbentValue)
+			{
+				search.trail.retain(state.trail);
+				search.trail.release(search.incumbentTrail);
+				search.incumbentValue = state.value;
+				search.incumbentTrail = state.trail;
+			}
+
+			merged.push_back(state);
+		}
+
+		for (int d = 0; d < (int)search.dropped.size(); d++)
+			search.trail.release(search.dropped[d]);
+
+		states.swap(merged);
+	}
+}
+
+void coreKnapsack(knapsack &k)
+// Solve the knapsack problem exactly with an expanding core around the break item.
+{
+	coreSearch search;
+	search.k = &k;
+	search.items = k.sort();
+
+	int numObjects = k.getNumObjects();
+	int costLimit = k.getCostLimit();
+
+	// The break item is the first item in the density order that no longer fits
+	int breakItem = 0;
+	int breakCost = 0;
+	int breakValue = 0;
+	while (breakItem < numObjects && breakCost + k.getCost(search.items[breakItem]) <= costLimit)
+	{
+		breakCost += k.getCost(search.items[breakItem]);
+		breakValue += k.getValue(search.items[breakItem]);
+		breakItem++;
+	}
+
+	search.incumbentValue = breakValue;
+	search.incumbentTrail = decisionTrail::none;
+
+	coreState start = { breakCost, breakValue, decisionTrail::none };
+	search.states.push_back(start);
+
+	int left = breakItem - 1;
+	int right = breakItem;
+
+	while (!search.states.empty() && (left >= 0 || right < numObjects))
+	{
+		if (right < numObjects)
+		{
+			addItem(search, search.items[right], 1, left, right + 1);
+			right++;
+		}
+
+		if (left >= 0 && !search.states.empty())
+		{
+			addItem(search, search.items[left], -1, left - 1, right);
+			left--;
+		}
+	}
+
+	// The incumbent is the break solution with the items on its trail flipped
+	vector<int> flipped;
+	search.trail.getItems(search.incumbentTrail, flipped);
+
+	for (int i = 0; i < numObjects; i++)
+		k.unSelect(i);
+	for (int i = 0; i < breakItem; i++)
+		k.select(search.items[i]);
+	for (int i = 0; i < (int)flipped.size(); i++)
+	{
+		if (k.isSelected(flipped[i]))
+			k.unSelect(flipped[i]);
+		else
+			k.select(flipped[i]);
+	}
+}
@@ -0,0 +1,6 @@
+// Expanding core solver for the knapsack problem
+#pragma once
+
+#include "knapsack.h"
+
+void coreKnapsack(knapsack &k);
@@ -0,0 +1,75 @@
+// File: csrgraph.cpp
+// Builds the compressed sparse row graph by counting sort on the edge list: one pass counts the
+// degrees, a prefix sum turns them into offsets, and a second pass drops each endpoint into the
+// other's slot.
+
+#include "csrgraph.h"
+
+using namespace std;
+
+csrGraph::csrGraph()
+// Construct an empty graph.
+	: numNodes(0), numEdges(0), offset(1, 0)
+{
+}
+
+csrGraph::csrGraph(const colorData &data)
+// Construct the graph of a loaded color.format file.
+	: numNodes(data.numNodes), numEdges(data.numEdges)
+{
+	build(data.getEdges());
+}
+
+csrGraph::csrGraph(int numNodes, const vector<int> &edges)
+// Construct a graph on numNodes vertices from pairs of endpoints.
+	: numNodes(numNodes), numEdges((int)edges.size() / 2)
+{
+	if (numNodes < 0 || edges.size() % 2 != 0)
+		throw rangeError("Bad graph size in csrGraph::csrGraph");
+
+	for (int i = 0; i < (int)edges.size(); i++)
+		if (edges[i] < 0 || edges[i] >= numNodes)
+			throw rangeError("Bad endpoint in csrGraph::csrGraph");
+
+	build(edges.data());
+}
+
+void csrGraph::build(const int *edges)
+// Fill offset and adjacency from numEdges pairs of endpoints.
+{
+	offset.assign(numNodes + 1, 0);
+	for (int i = 0; i < numEdges; i++)
+	{
+		int s = edges[2 * i];
+		int t = edges[2 * i + 1];
+		offset[s + 1]++;
+		if (t != s)
+			offset[t + 1]++;
+	}
+
+	for (int v = 0; v < numNodes; v++)
+		offset[v + 1] += offset[v];
+
+	adjacency.resize(offset[numNodes]);
+	vector<int> next(offset.begin(), offset.end() - 1);
+	for (int i = 0; i < numEdges; i++)
+	{
+		int s = edges[2 * i];
+		int t = edges[2 * i + 1];
+		adjacency[next[s]++] = t;
+		if (t != s)
+			adjacency[next[t]++] = s;
+	}
+}
+
+int csrGraph::getNumNodes() const
+// Return the number of vertices.
+{
+	return numNodes;
+}
+
+int csrGraph::getNumEdges() const
+// Return the number of edges.
+{
+	return numEdges;
+}
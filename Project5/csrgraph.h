@@ -0,0 +1,60 @@
+// Compressed sparse row graph for the coloring solvers
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "loader.h"
+
+using namespace std;
+
+// Vertex colors, indexed by vertex and kept apart from the graph so that a search touches only
+// the adjacency it reads and one small integer per neighbor.
+typedef vector<unsigned short> coloring;
+
+const int maxColors = 65536;
+
+// Called with the conflict count and coloring of each new best coloring
+typedef function<void(int numConflicts, const coloring &colors)> coloringCallback;
+
+// An immutable undirected graph.  The neighbors of v are adjacency[offset[v]] up to
+// adjacency[offset[v + 1]], so every edge costs two ints and a vertex's neighbors are
+// read sequentially.  Parallel edges are kept, as the BGL graph keeps them.
+class csrGraph
+{
+public:
+	csrGraph();
+	csrGraph(const colorData &data);
+	csrGraph(int numNodes, const vector<int> &edges);
+	int getNumNodes() const;
+	int getNumEdges() const;
+	int degree(int v) const;
+	const int *adjacentBegin(int v) const;
+	const int *adjacentEnd(int v) const;
+
+private:
+	int numNodes;
+	int numEdges;
+	vector<int> offset;
+	vector<int> adjacency;
+
+	void build(const int *edges);
+};
+
+inline int csrGraph::degree(int v) const
+// Return the number of neighbors of v, counting a self loop once.
+{
+	return offset[v + 1] - offset[v];
+}
+
+inline const int *csrGraph::adjacentBegin(int v) const
+// Return the first neighbor of v.
+{
+	return adjacency.data() + offset[v];
+}
+
+inline const int *csrGraph::adjacentEnd(int v) const
+// Return one past the last neighbor of v.
+{
+	return adjacency.data() + offset[v + 1];
+}
@@ -1,3 +1,6 @@
+#ifndef RANDOM_NUMBER_CLASS
+#define RANDOM_NUMBER_CLASS
+
 #include <iostream>
 #include <time.h>
 
@@ -21,20 +24,16 @@ public:
 	double frandom();
 
 private:
-	static const long A;
-	static const long M;
-	static const long Q;
-	static const long R;
+	static const long A = 48271;
+	static const long M = 2147483647;
+	static const long Q = M / A;
+	static const long R = M % A;
 
 	long seed;
 };
 
-const long randomNumber::A = 48271;
-const long randomNumber::M = 2147483647;
-const long randomNumber::Q = M / A;
-const long randomNumber::R = M % A;
-
-randomNumber::randomNumber(long s)
+// Members are inline so that more than one source file can include this header
+inline randomNumber::randomNumber(long s)
 {
 	if (s < 0)
 		s = 0;
@@ -60,7 +59,7 @@ randomNumber::randomNumber(long s)
 	seed = s;
 }
 
-long randomNumber::random()
+inline long randomNumber::random()
 {
 	long tmpSeed = A * (seed % Q) - R * (seed / Q);
 
@@ -72,14 +71,16 @@ long randomNumber::random()
 	return seed;
 }
 
-long randomNumber::random(long n)
+inline long randomNumber::random(long n)
 {
 	double fraction = double(random()) / double(M);
 
 	return int(fraction * n);
 }
 
-double randomNumber::frandom()
+inline double randomNumber::frandom()
 {
 	return double(random()) / double(M);
-}
\ No newline at end of file
+}
+
+#endif	// RANDOM_NUMBER_CLASS
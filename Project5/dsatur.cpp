@@ -0,0 +1,120 @@
+// File: dsatur.cpp
+// Colors a graph with Brelaz's DSatur rule, limited to numColors colors.  The next node colored is
+// the uncolored node with the most distinct colors among its neighbors (its saturation), ties
+// going to the node of highest degree, and it takes the lowest color no neighbor has.  Each node
+// keeps the colors of its neighbors as a bitset, so the saturation changes only when a bit is
+// first set and the lowest free color is a scan for the first clear bit.  When all numColors
+// colors are taken, the node takes the color fewest of its neighbors have.
+// Nodes wait in a heap keyed by (saturation, degree).  A neighbor whose saturation rises gets a
+// new entry, and the old one is skipped when popped.  Saturation rises at most once per edge end
+// and at most k times per node, so there are at most V + min(2E, Vk) entries and the whole
+// coloring takes O((V + E) log V + Vk / 64) time.
+
+#include <algorithm>
+#include <queue>
+
+#include "d_except.h"
+#include "dsatur.h"
+#include "solution.h"
+
+using namespace std;
+
+namespace
+{
+	struct dsaturEntry
+	{
+		int saturation;
+		int degree;
+		int node;
+
+		bool operator<(const dsaturEntry &e) const
+		// Order entries so that the heap's top is the most saturated, then the highest degree,
+		// then the lowest numbered node.
+		{
+			if (saturation != e.saturation)
+				return saturation < e.saturation;
+			if (degree != e.degree)
+				return degree < e.degree;
+			return node > e.node;
+		}
+	};
+}
+
+int dsaturColor(const csrGraph &g, coloring &colors, int numColors)
+// Color every node of g with one of numColors colors by DSatur and return the number of
+// conflicts.
+{
+	if (numColors < 1 || numColors > maxColors)
+		throw rangeError("Bad number of colors in dsaturColor");
+
+	int n = g.getNumNodes();
+	int words = (numColors + 63) / 64;
+
+	// Bit c of node v's words is set once a neighbor of v has color c
+	vector<unsigned long long> neighborColors((size_t)n * words, 0);
+	vector<int> saturation(n, 0);
+	vector<bool> colored(n, false);
+	vector<int> count(numColors);
+	int numConflicts = 0;
+
+	colors.assign(n, 0);
+
+	priority_queue<dsaturEntry> open;
+	for (int v = 0; v < n; v++)
+	{
+		dsaturEntry e = { 0, g.degree(v), v };
+		open.push(e);
+	}
+
+	while (!open.empty())
+	{
+		dsaturEntry e = open.top();
+		open.pop();
+
+		int v = e.node;
+		if (colored[v] || e.saturation != saturation[v])
+			continue;
+
+		// The lowest color no neighbor has, or failing that the one fewest neighbors have
+		const unsigned long long *taken = &neighborColors[(size_t)v * words];
+		int color = numColors;
+		for (int w = 0; w < words && color == numColors; w++)
+			if (~taken[w] != 0)
+				color = min(numColors, 64 * w + lowestBit(~taken[w]));
+
+		if (color == numColors)
+		{
+			fill(count.begin(), count.end(), 0);
+			for (const int *u = g.adjacentBegin(v); u != g.adjacentEnd(v); ++u)
+				if (colored[*u])
+					count[colors[*u]]++;
+
+			color = (int)(min_element(count.begin(), count.end()) - count.begin());
+			numConflicts += count[color];
+		}
+
+		colors[v] = (unsigned short)color;
+		colored[v] = true;
+
+		for (const int *u = g.adjacentBegin(v); u != g.adjacentEnd(v); ++u)
+		{
+			if (*u == v)
+				numConflicts++;
+			if (colored[*u])
+				continue;
+
+			unsigned long long &word = neighborColors[(size_t)*u * words + color / 64];
+			unsigned long long bit = 1ULL << (color % 64);
+			if ((word & bit) != 0)
+				continue;
+
+			word |= bit;
+			saturation[*u]++;
+
+			dsaturEntry next = { saturation[*u], g.degree(*u), *u };
+			open.push(next);
+		}
+	}
+
+	return numConflicts;
+}
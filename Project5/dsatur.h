@@ -0,0 +1,6 @@
+// DSatur initial coloring for the coloring solvers
+#pragma once
+
+#include "csrgraph.h"
+
+int dsaturColor(const csrGraph &g, coloring &colors, int numColors);
@@ -0,0 +1,213 @@
+// File: fptas.cpp
+// Approximates the knapsack problem to within a factor of 1 - epsilon by scaling the values.
+// With L the better of the greedy solution and the best single item, L is at least half the
+// optimum.  Every value is divided by K = epsilon L / n and rounded down, and the scaled problem
+// is solved exactly by dynamic programming over scaled value, keeping for each scaled value p the
+// least cost of a set of items worth at least p.  Rounding loses less than K per item, so less
+// than epsilon L in all, and the scaled optimum is worth at least (1 - epsilon) of the optimum.
+// Scaled values run up to the LP bound over K, which is at most 2n / epsilon, so a row takes
+// O(n / epsilon) memory and the pass over all items O(n^2 / epsilon) time.  The solution is
+// recovered by divide and conquer, as in knapsackdp.cpp, which keeps the memory at one row per
+// level of the recursion for about twice the time of a single pass.
+
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+
+#include "fptas.h"
+
+using namespace std;
+
+namespace
+{
+	const long long unreachable = LLONG_MAX / 2;
+
+	struct scaledItems
+	{
+		vector<int> item;	// item numbers in k
+		vector<int> cost;
+		vector<int> value;	// scaled
+	};
+
+	void leastCosts(const scaledItems &s, int first, int last, int target, vector<long long> &row, vector<long long> &scratch)
+	// Set row[p] to the least cost of a set of items first..last-1 with scaled value at least p,
+	// for every p <= target.
+	{
+		row.assign(target + 1, unreachable);
+		row[0] = 0;
+		scratch.resize(target + 1);
+
+		for (int i = first; i < last; i++)
+		{
+			int v = min(s.value[i], target);
+			long long c = s.cost[i];
+			const long long *prev = &row[0];
+			long long *next = &scratch[0];
+
+			// Taking the item reaches every p <= v on its own
+			for (int p = 0; p <= v; p++)
+				next[p] = min(prev[p], c);
+			for (int p = v + 1; p <= target; p++)
+				next[p] = min(prev[p], prev[p - v] + c);
+
+			row.swap(scratch);
+		}
+	}
+
+	void recover(const scaledItems &s, int first, int last, long long capacity, int target, Solution &items)
+	// Add to items a set of items first..last-1 with cost at most capacity and scaled value at
+	// least target.  Such a set must exist.
+	{
+		if (target == 0)
+			return;
+
+		if (last - first == 1)
+		{
+			items.set(s.item[first]);
+			return;
+		}
+
+		int middle = first + (last - first) / 2;
+		int split = 0;
+		long long leftCost = 0;
+
+		{
+			vector<long long> left, right, scratch;
+			leastCosts(s, first, middle, target, left, scratch);
+			leastCosts(s, middle, last, target, right, scratch);
+
+			while (left[split] + right[target - split] > capacity)
+				split++;
+			leftCost = left[split];
+		}
+
+		recover(s, first, middle, leftCost, split, items);
+		recover(s, middle, last, capacity - leftCost, target - split, items);
+	}
+}
+
+void fptasKnapsack(knapsack &k, double epsilon, fptasResult &r)
+// Select in k a solution worth at least (1 - epsilon) of the optimum, for 0 < epsilon < 1, and
+// describe it in r.  Anything selected in k beforehand is ignored.
+{
+	if (!(epsilon > 0 && epsilon < 1))
+		throw rangeError("Bad epsilon in fptasKnapsack");
+
+	int n = k.getNumObjects();
+	long long limit = k.getCostLimit();
+	const vector<int> &order = k.sort();
+
+	// Lower bound: greedy in density order, or the best single item if that is better.
+	// The LP bound is at most the greedy prefix plus the item where it stops.
+	Solution greedy(n);
+	long long room = limit;
+	long long greedyValue = 0;
+	long long lpBound = -1;
+	int bestItem = -1;
+	for (int i = 0; i < n; i++)
+	{
+		int item = order[i];
+		if (k.getCost(item) <= room)
+		{
+			room -= k.getCost(item);
+			greedyValue += k.getValue(item);
+			greedy.set(item);
+		}
+		else if (lpBound < 0)
+			lpBound = greedyValue + room * k.getValue(item) / k.getCost(item);
+
+		if (k.getCost(item) <= limit && (bestItem < 0 || k.getValue(item) > k.getValue(bestItem)))
+			bestItem = item;
+	}
+	if (lpBound < 0)
+		lpBound = greedyValue;
+
+	Solution best = greedy;
+	long long bestValue = greedyValue;
+	if (bestItem >= 0 && k.getValue(bestItem) > bestValue)
+	{
+		best = Solution(n);
+		best.set(bestItem);
+		bestValue = k.getValue(bestItem);
+	}
+
+	// The items that can be in a solution, with their values scaled
+	scaledItems s;
+	for (int i = 0; i < n; i++)
+		if (k.getCost(i) <= limit && k.getValue(i) > 0)
+			s.item.push_back(i);
+
+	int m = (int)s.item.size();
+	double scale = max(1.0, epsilon * bestValue / max(m, 1));
+	long long top = (long long)floor(lpBound / scale);
+	if (top >= INT_MAX)
+		throw rangeError("epsilon is too small for the scaled values to fit an int in fptasKnapsack");
+
+	s.cost.resize(m);
+	s.value.resize(m);
+	for (int i = 0; i < m; i++)
+	{
+		s.cost[i] = k.getCost(s.item[i]);
+		s.value[i] = (int)min((long long)floor(k.getValue(s.item[i]) / scale), top);
+	}
+
+	if (m > 0)
+	{
+		int target = 0;
+		{
+			vector<long long> row, scratch;
+			leastCosts(s, 0, m, (int)top, row, scratch);
+			for (int p = (int)top; p > 0 && target == 0; p--)
+				if (row[p] <= limit)
+					target = p;
+		}
+
+		Solution items(n);
+		recover(s, 0, m, limit, target, items);
+
+		// Rounding can leave room for more; fill it in density order
+		long long cost = 0;
+		long long value = 0;
+		for (int i = items.first(); i != -1; i = items.next(i))
+		{
+			cost += k.getCost(i);
+			value += k.getValue(i);
+		}
+		for (int i = 0; i < n; i++)
+		{
+			int item = order[i];
+			if (!items.test(item) && cost + k.getCost(item) <= limit)
+			{
+				items.set(item);
+				cost += k.getCost(item);
+				value += k.getValue(item);
+			}
+		}
+
+		if (value > bestValue)
+		{
+			best = items;
+			bestValue = value;
+		}
+	}
+
+	k.setItems(best);
+
+	r.epsilon = epsilon;
+	r.scale = scale;
+	r.lowerBound = (int)max(greedyValue, bestItem < 0 ? 0LL : (long long)k.getValue(bestItem));
+	r.rowEntries = top + 1;
+	r.value = k.getValue();
+	r.bound = k.bound(0, 0, 0, martelloTothBound);
+	r.gap = r.bound > 0 ? (r.bound - r.value) / (double)r.bound : 0;
+}
+
+double fptasKnapsack(knapsack &k, double epsilon)
+// Select in k a solution worth at least (1 - epsilon) of the optimum, and return its gap
+// against knapsack::bound.
+{
+	fptasResult r;
+	fptasKnapsack(k, epsilon, r);
+
+	return r.gap;
+}
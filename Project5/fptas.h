@@ -0,0 +1,20 @@
+// Fully polynomial approximation scheme for the knapsack problem
+#pragma once
+
+#include "knapsack.h"
+
+// What fptasKnapsack found.  value is at least (1 - epsilon) of the optimum, and the optimum is
+// at most bound, so gap is a certified upper limit on how far value can be from optimal.
+struct fptasResult
+{
+	double epsilon;
+	double scale;			// values are divided by scale and rounded down
+	int lowerBound;			// the better of greedy and the best single item, at least half the optimum
+	long long rowEntries;	// length of the dynamic programming rows
+	int value;
+	int bound;				// knapsack::bound of the empty solution, with the Martello-Toth bound
+	double gap;				// (bound - value) / bound
+};
+
+void fptasKnapsack(knapsack &k, double epsilon, fptasResult &r);
+double fptasKnapsack(knapsack &k, double epsilon);
@@ -0,0 +1,115 @@
+// File: generator.cpp
+// Generates knapsack instances in the classes of Pisinger's generator.  With data range R, costs
+// (or values, for the inverse class) are uniform in [1, R], and
+//   uncorrelated:                values uniform in [1, R]
+//   weakly correlated:           value uniform in [cost - R/10, cost + R/10], at least 1
+//   strongly correlated:         value = cost + R/10
+//   inverse strongly correlated: cost = value + R/10
+//   subset sum:                  value = cost
+// The cost limit is half the total cost.  Totals must fit in an int, since the knapsack class
+// keeps its prefix sums as ints, so defaultRange shrinks R as the instance grows.
+
+#include <algorithm>
+#include <limits.h>
+#include <stdio.h>
+
+#include "d_random.h"
+#include "generator.h"
+
+using namespace std;
+
+const char *instanceClassName(instanceClass type)
+{
+	switch (type)
+	{
+	case uncorrelated: return "uncorrelated";
+	case weaklyCorrelated: return "weakly";
+	case stronglyCorrelated: return "strongly";
+	case inverseStronglyCorrelated: return "inverse";
+	case subsetSum: return "subsetsum";
+	}
+
+	return "unknown";
+}
+
+int defaultRange(int numObjects)
+// Return the data range used for numObjects items: 1000, or less where the totals would overflow.
+{
+	long long range = 1000;
+	if (numObjects > 0)
+		range = min(range, (long long)INT_MAX / numObjects / 2);
+
+	return (int)max(range, 10LL);
+}
+
+void generateKnapsack(knapsackData &data, instanceClass type, int numObjects, int range, long seed)
+// Fill data with a numObjects-item instance of the given class and data range.
+{
+	if (numObjects < 0 || range < 10)
+		throw rangeError("Bad size or range in generateKnapsack");
+
+	randomNumber random(seed);
+	int spread = range / 10;
+
+	data.numObjects = numObjects;
+	data.cache.reset();
+	data.value.resize(numObjects);
+	data.cost.resize(numObjects);
+
+	long long totalCost = 0;
+	long long totalValue = 0;
+	for (int i = 0; i < numObjects; i++)
+	{
+		int r = 1 + (int)random.random(range);
+		int c, v;
+
+		switch (type)
+		{
+		case uncorrelated:
+			c = r;
+			v = 1 + (int)random.random(range);
+			break;
+		case weaklyCorrelated:
+			c = r;
+			v = max(1, c - spread + (int)random.random(2 * spread + 1));
+			break;
+		case stronglyCorrelated:
+			c = r;
+			v = c + spread;
+			break;
+		case inverseStronglyCorrelated:
+			v = r;
+			c = v + spread;
+			break;
+		default:
+			c = r;
+			v = r;
+			break;
+		}
+
+		data.cost[i] = c;
+		data.value[i] = v;
+		totalCost += c;
+		totalValue += v;
+	}
+
+	if (totalCost > INT_MAX || totalValue > INT_MAX)
+		throw rangeError("Totals overflow an int in generateKnapsack; use a smaller range");
+
+	data.costLimit = (int)(totalCost / 2);
+}
+
+void writeKnapsack(const string &fileName, const knapsackData &data)
+// Write data to fileName in knapsack.format.
+{
+	FILE *fout = fopen(fileName.c_str(), "w");
+	if (fout == NULL)
+		throw fileOpenError(fileName);
+
+	fprintf(fout, "%d\n%d\n", data.numObjects, data.costLimit);
+	for (int i = 0; i < data.numObjects; i++)
+		fprintf(fout, "%5d %5d %5d\n", i, data.value[i], data.cost[i]);
+
+	if (fclose(fout) != 0)
+		throw fileError("Cannot write " + fileName);
+}
@@ -0,0 +1,16 @@
+// Synthetic knapsack instance generator
+#pragma once
+
+#include <string>
+
+#include "loader.h"
+
+// The standard hard instance classes of Pisinger's generator
+enum instanceClass { uncorrelated, weaklyCorrelated, stronglyCorrelated, inverseStronglyCorrelated, subsetSum };
+
+const int numInstanceClasses = 5;
+
+const char *instanceClassName(instanceClass type);
+int defaultRange(int numObjects);
+void generateKnapsack(knapsackData &data, instanceClass type, int numObjects, int range, long seed);
+void writeKnapsack(const string &fileName, const knapsackData &data);
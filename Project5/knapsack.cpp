@@ -1,4 +1,23 @@
+#include <algorithm>
+#include <limits.h>
+
 #include "knapsack.h"
+#include "searchstats.h"
+
+namespace
+{
+	// Orders items by decreasing value/cost, compared exactly by cross-multiplying
+	struct densityGreater
+	{
+		const vector<int> *value;
+		const vector<int> *cost;
+
+		bool operator()(int a, int b) const
+		{
+			return (long long)(*value)[a] * (*cost)[b] > (long long)(*value)[b] * (*cost)[a];
+		}
+	};
+}
 
 knapsack::knapsack(ifstream &fin)
 // Construct a new knapsack instance using the data in fin.
@@ -13,7 +32,7 @@ knapsack::knapsack(ifstream &fin)
 
 	value.resize(n);
 	cost.resize(n);
-	selected.resize(n);
+	selected = Solution(n);
 
 	for (int i = 0; i < n; i++)
 	{
@@ -26,61 +45,108 @@ knapsack::knapsack(ifstream &fin)
 	totalValue = 0;
 	totalCost = 0;
 	currentItem = 0;
+
+	initializeOrder();
 }
 
-knapsack::knapsack(const knapsack &k)
-// Knapsack copy constructor.
+knapsack::knapsack(int costLimit, const vector<int> &value, const vector<int> &cost)
+// Construct a new knapsack instance from arrays of values and costs indexed by object id.
+	: numObjects((int)value.size()), costLimit(costLimit), value(value), cost(cost),
+	selected((int)value.size()), totalValue(0), totalCost(0), currentItem(0)
 {
-	int n = k.getNumObjects();
+	if (value.size() != cost.size())
+		throw rangeError("Value and cost counts differ in knapsack::knapsack");
 
-	value.resize(n);
-	cost.resize(n);
-	selected.resize(n);
-	numObjects = k.getNumObjects();
-	costLimit = k.getCostLimit();
+	initializeOrder();
+}
 
-	totalCost = 0;
-	totalValue = 0;
-	currentItem = k.getCurrentItem();
+knapsack::knapsack(const knapsackData &data)
+// Construct a new knapsack instance from loaded or generated data, copying its arrays once.
+	: numObjects(data.numObjects), costLimit(data.costLimit),
+	value(data.getValues(), data.getValues() + data.numObjects),
+	cost(data.getCosts(), data.getCosts() + data.numObjects),
+	selected(data.numObjects), totalValue(0), totalCost(0), currentItem(0)
+{
+	initializeOrder();
+}
 
-	for (int i = 0; i < n; i++)
-	{
-		value[i] = k.getValue(i);
-		cost[i] = k.getCost(i);
-		if (k.isSelected(i))
-			select(i);
-		else
-			unSelect(i);
-	}
+knapsack::knapsack(const knapsack &k)
+// Knapsack copy constructor.
+{
+	*this = k;
 }
 
 knapsack &knapsack::operator=(const knapsack &k)
 // Knapsack assignment operator.
 {
-	int n = k.getNumObjects();
+	numObjects = k.numObjects;
+	costLimit = k.costLimit;
+	value = k.value;
+	cost = k.cost;
+	selected = k.selected;
+	totalValue = k.totalValue;
+	totalCost = k.totalCost;
+	currentItem = k.currentItem;
+
+	order = k.order;
+	position = k.position;
+	prefixCost = k.prefixCost;
+	prefixValue = k.prefixValue;
+	suffixMinCost = k.suffixMinCost;
+	selectedCostTree = k.selectedCostTree;
+	selectedValueTree = k.selectedValueTree;
+	fenwickStep = k.fenwickStep;
 
-	value.resize(n);
-	cost.resize(n);
-	selected.resize(n);
-	numObjects = k.getNumObjects();
-	costLimit = k.getCostLimit();
+	return *this;
+}
 
-	totalCost = k.getCost();
-	totalValue = k.getValue();
-	currentItem = k.getCurrentItem();
+void knapsack::initializeOrder()
+// Sort the items by density once, and build the prefix sums and selected-item trees
+// that bound() searches.
+{
+	order.resize(numObjects);
+	for (int i = 0; i < numObjects; i++)
+		order[i] = i;
 
-	for (int i = 0; i < n; i++)
+	// Stable, so items of equal density stay in index order; the old quicksort went quadratic
+	// when many items shared a density
+	densityGreater greater = { &value, &cost };
+	stable_sort(order.begin(), order.end(), greater);
+
+	position.resize(numObjects);
+	prefixCost.assign(numObjects + 1, 0);
+	prefixValue.assign(numObjects + 1, 0);
+
+	for (int i = 0; i < numObjects; i++)
 	{
-		value[i] = k.getValue(i);
-		cost[i] = k.getCost(i);
-		selected[i] = k.isSelected(i);
-		/*if (k.isSelected(i))
-			select(i);
-		else
-			unSelect(i);*/
+		position[order[i]] = i;
+		prefixCost[i + 1] = prefixCost[i] + cost[order[i]];
+		prefixValue[i + 1] = prefixValue[i] + value[order[i]];
 	}
 
-	return *this;
+	suffixMinCost.assign(numObjects + 1, INT_MAX);
+	for (int i = numObjects - 1; i >= 0; i--)
+		suffixMinCost[i] = min(suffixMinCost[i + 1], cost[order[i]]);
+
+	selectedCostTree.assign(numObjects + 1, 0);
+	selectedValueTree.assign(numObjects + 1, 0);
+
+	fenwickStep = 1;
+	while (fenwickStep * 2 <= numObjects)
+		fenwickStep *= 2;
+
+	for (int i = selected.first(); i != -1; i = selected.next(i))
+		updateSelectedTrees(i, 1);
+}
+
+void knapsack::updateSelectedTrees(int i, int sign)
+// Add (sign = 1) or remove (sign = -1) item i from the selected-item trees.
+{
+	for (int p = position[i] + 1; p <= numObjects; p += p & -p)
+	{
+		selectedCostTree[p] += sign * cost[i];
+		selectedValueTree[p] += sign * value[i];
+	}
 }
 
 int knapsack::getNumObjects() const
@@ -134,33 +200,189 @@ float knapsack::getPriority(int i) const
 	return (float)value[i] / (float)cost[i];
 }
 
-float knapsack::bound(int currItem)
-// Find bound on current knapsack value by solving partial knapsack problem on the empty space in the knapsack
+int knapsack::bound(int currItem) const
+// Find bound on current knapsack value by solving partial knapsack problem on the empty space in the knapsack.
+// Unselected items from position currItem of the density order are packed whole up to the critical item,
+// which takes the remaining space fractionally.  The critical item is found by fillPrefix, which corrects
+// the prefix sums for items already in the knapsack.  Values are integers, so the fraction is rounded
+// down exactly and the bound is the floor of the LP bound.
+{
+	STAT_ADD(boundCalls, 1);
+	STAT_TIMER(boundNanoseconds);
+
+	if (totalCost >= costLimit || currItem >= numObjects)
+		return totalValue;
+
+	// Cost and value of the unselected items ahead of currItem, which the descent must step over
+	int skippedCost = prefixCost[currItem];
+	int skippedValue = prefixValue[currItem];
+	for (int p = currItem; p > 0; p -= p & -p)
+	{
+		skippedCost -= selectedCostTree[p];
+		skippedValue -= selectedValueTree[p];
+	}
+
+	int room = costLimit - totalCost + skippedCost;
+	int fillCost;
+	int fillValue;
+	int critical = fillPrefix(room, fillCost, fillValue);
+
+	int theBound = totalValue + fillValue - skippedValue;
+
+	if (critical < numObjects)
+		theBound += (int)((long long)(room - fillCost) * value[order[critical]] / cost[order[critical]]);
+
+	return theBound;
+}
+
+int knapsack::fillPrefix(int room, int &fillCost, int &fillValue) const
+// Find the longest prefix of the density order whose unselected items fit in room, by a binary
+// descent over the selected-item trees.  Sets the cost and value of those unselected items and
+// returns the length of the prefix, which is also the position of the first item that did not fit.
 {
-	int theCost = getCost();
-	float theBound = getValue();
-	vector<int> items = sort();
+	int length = 0;
+	fillCost = 0;
+	fillValue = 0;
 
-	for (int i = currItem; i < numObjects && theCost < costLimit; i++)
+	for (int step = fenwickStep; step > 0; step /= 2)
 	{
-		int item = items[i];
-		if (selected[item])
+		int next = length + step;
+		if (next > numObjects)
 			continue;
 
-		if (cost[item] + theCost <= costLimit)
+		int rangeCost = prefixCost[next] - prefixCost[length] - selectedCostTree[next];
+		if (fillCost + rangeCost <= room)
+		{
+			fillCost += rangeCost;
+			fillValue += prefixValue[next] - prefixValue[length] - selectedValueTree[next];
+			length = next;
+		}
+	}
+
+	return length;
+}
+
+int knapsack::bound(int currItem, int cost, int value) const
+// Bound a partial solution in which the items before position currItem of the density order
+// have been decided, with the given total cost and value, and every later item is still free.
+// Nothing selected in this knapsack is taken into account, so the bound only reads the prefix sums.
+// As with bound(currItem), it is the floor of the LP bound.
+{
+	STAT_ADD(boundCalls, 1);
+	STAT_TIMER(boundNanoseconds);
+
+	if (cost >= costLimit || currItem >= numObjects)
+		return value;
+
+	// The critical item is the first one whose prefix cost no longer fits
+	int room = costLimit - cost;
+	vector<int>::const_iterator end = upper_bound(prefixCost.begin() + currItem, prefixCost.end(), prefixCost[currItem] + room);
+	int critical = (int)(end - prefixCost.begin()) - 1;
+
+	int theBound = value + prefixValue[critical] - prefixValue[currItem];
+
+	if (critical < numObjects)
+		theBound += (int)((long long)(room - prefixCost[critical] + prefixCost[currItem]) * this->value[order[critical]] / this->cost[order[critical]]);
+
+	return theBound;
+}
+
+int knapsack::bound(int currItem, int cost, int value, boundType type) const
+// Bound a partial solution as bound(currItem, cost, value) does, with the given bound.
+{
+	if (type == dantzigBound || cost >= costLimit || currItem >= numObjects)
+		return bound(currItem, cost, value);
+
+	STAT_ADD(boundCalls, 1);
+	STAT_TIMER(boundNanoseconds);
+
+	int room = costLimit - cost;
+	int critical = (int)(upper_bound(prefixCost.begin() + currItem, prefixCost.end(), prefixCost[currItem] + room) - prefixCost.begin()) - 1;
+	long long theBound = value + prefixValue[critical] - prefixValue[currItem];
+	if (critical == numObjects)
+		return (int)theBound;
+
+	theBound += (long long)(room - prefixCost[critical] + prefixCost[currItem]) * this->value[order[critical]] / this->cost[order[critical]];
+
+	long long strong;
+	if (type == martelloTothBound)
+	{
+		// U2 is the window of the critical item alone, written out
+		long long fillValue = prefixValue[critical] - prefixValue[currItem];
+		long long left = room - (prefixCost[critical] - prefixCost[currItem]);
+		int item = order[critical];
+
+		// Leave the critical item out and fill with the next one
+		strong = fillValue;
+		if (critical + 1 < numObjects && this->cost[order[critical + 1]] > 0)
+			strong += left * this->value[order[critical + 1]] / this->cost[order[critical + 1]];
+
+		// Or take it and shed the excess from the item before it
+		if (critical > currItem && this->cost[order[critical - 1]] > 0)
+		{
+			int before = order[critical - 1];
+			long long excess = this->cost[item] - left;
+			strong = max(strong, fillValue + this->value[item] - (excess * this->value[before] + this->cost[before] - 1) / this->cost[before]);
+		}
+	}
+	else
+		strong = windowBound(currItem, room, max(currItem, critical - 2), min(numObjects, critical + 2));
+
+	return (int)min(theBound, value + strong);
+}
+
+long long knapsack::windowBound(int currItem, int room, int first, int last) const
+// Bound the items from position currItem on, with room to fill, by trying every choice of the
+// items at positions first to last - 1.  In each case the items before first are all taken,
+// and the LP relaxation of the rest is bounded from the density of item first - 1 if the
+// knapsack is overfull, or of item last if there is room left over.
+{
+	long long beforeCost = prefixCost[first] - prefixCost[currItem];
+	long long beforeValue = prefixValue[first] - prefixValue[currItem];
+	long long best = LLONG_MIN;
+
+	for (int mask = 0; mask < (1 << (last - first)); mask++)
+	{
+		long long totalCost = beforeCost;
+		long long totalValue = beforeValue;
+		for (int i = first; i < last; i++)
+		{
+			if (mask & (1 << (i - first)))
+			{
+				totalCost += cost[order[i]];
+				totalValue += value[order[i]];
+			}
+		}
+
+		long long theBound;
+		if (totalCost <= room)
 		{
-			theCost += cost[item];
-			theBound += value[item];
+			theBound = totalValue;
+			if (last < numObjects && cost[order[last]] > 0)
+				theBound += (room - totalCost) * value[order[last]] / cost[order[last]];
 		}
 		else
 		{
-			int diff = costLimit - theCost;
-			float partialValue = diff * getPriority(item);
-			theCost += diff;
-			theBound += partialValue;
+			// Shed the excess from the items before the window, at no less than their lowest density
+			if (first == currItem || cost[order[first - 1]] == 0)
+				continue;
+
+			int item = order[first - 1];
+			long long excess = totalCost - room;
+			theBound = totalValue - (excess * value[item] + cost[item] - 1) / cost[item];
 		}
+
+		best = max(best, theBound);
 	}
-	return theBound;
+
+	return best;
+}
+
+int knapsack::getMinCost(int currItem) const
+// Return the smallest cost among the items from position currItem of the density order,
+// or INT_MAX if there are none.
+{
+	return suffixMinCost[currItem];
 }
 
 void knapsack::nextItem()
@@ -204,9 +426,8 @@ void knapsack::printSolution()
 	cout << "Total cost: " << getCost() << endl << endl;
 
 	// Print out objects in the solution
-	for (int i = 0; i < getNumObjects(); i++)
-		if (isSelected(i))
-			cout << i << "  " << getValue(i) << " " << getCost(i) << endl;
+	for (int i = selected.first(); i != -1; i = selected.next(i))
+		cout << i << "  " << getValue(i) << " " << getCost(i) << endl;
 
 	cout << endl;
 }
@@ -226,11 +447,12 @@ void knapsack::select(int i)
 	if (i < 0 || i >= getNumObjects())
 		throw rangeError("Bad value in knapsack::Select");
 
-	if (selected[i] == false)
+	if (!selected.test(i))
 	{
-		selected[i] = true;
+		selected.set(i);
 		totalCost = totalCost + getCost(i);
 		totalValue = totalValue + getValue(i);
+		updateSelectedTrees(i, 1);
 	}
 }
 
@@ -240,52 +462,22 @@ void knapsack::unSelect(int i)
 	if (i < 0 || i >= getNumObjects())
 		throw rangeError("Bad value in knapsack::unSelect");
 
-	if (selected[i] == true)
+	if (selected.test(i))
 	{
-		selected[i] = false;
+		selected.reset(i);
 		totalCost = totalCost - getCost(i);
 		totalValue = totalValue - getValue(i);
+		updateSelectedTrees(i, -1);
 	}
 }
 
-int knapsack::partition(vector<int> &items, int left, int right, int pivot) const
-// Helper for quicksort
-// Put every item with a higher priority than the pivot to the left
-// Put every item with a lower priority than the pivot to the right
-{
-	for (int i = left; i < right; i++)
-	{
-		if (getPriority(items[i]) >= getPriority(pivot))
-		{
-			swap(items[i], items[left]);
-			left++;
-		}
-	}
-	return left - 1;
-}
-
-void knapsack::quicksort(vector<int> &items, int left, int right) const
-// Sorting items from highest to lowest priority using partition and recursion
-{
-	//partition(k, 0, k.getNumObjects() - 1, items);
-	if (left >= right)
-		return;
-
-	int middle = left + (right - left) / 2;
-	swap(items[middle], items[left]);
-	int midpoint = partition(items, left + 1, right, items[left]);
-	swap(items[left], items[midpoint]);
-	quicksort(items, left, midpoint);
-	quicksort(items, midpoint + 1, right);
-}
-
 bool knapsack::isSelected(int i) const
 // Return true if object i is currently selected, and false otherwise.
 {
 	if (i < 0 || i >= getNumObjects())
 		throw rangeError("Bad value in knapsack::getValue");
 
-	return selected[i];
+	return selected.test(i);
 }
 
 bool knapsack::isFathomed(int incumbent)
@@ -300,7 +492,7 @@ bool knapsack::isFathomed(int incumbent)
 
 	for (int i = 0; i < numObjects; i++)
 	{
-		if (selected[i])
+		if (selected.test(i))
 			continue;
 
 		if (totalCost + cost[i] <= costLimit)
@@ -310,48 +502,62 @@ bool knapsack::isFathomed(int incumbent)
 	return true;
 }
 
-vector<bool> knapsack::getSelected()
-// Return a vector of selected items
+const Solution &knapsack::getSelected() const
+// Return the set of selected items
 {
 	return selected;
 }
 
-vector<int> knapsack::sort() const
-// Public function to return a vector of item numbers, sorted via quicksort
+const vector<int> &knapsack::sort() const
+// Return the item numbers sorted by density.  The order is computed once when the knapsack
+// is read.
 {
-	vector<int> items(numObjects, 0);
-	for (int i = 0; i < numObjects; i++)
-		items[i] = i;
-
-	quicksort(items, 0, numObjects);
-
-	return items;
+	return order;
 }
 
 vector<int> knapsack::getIndicies() const
+// Return the numbers of the selected items in increasing order
 {
 	vector<int> indicies;
-
-	for (int i = 0; i < numObjects; i++)
-	{
-		if (isSelected(i))
-		{
-			indicies.push_back(i);
-		}
-	}
+	selected.getItems(indicies);
 
 	return indicies;
 }
 
-void knapsack::setItems(vector<int> includedIndicies)
+void knapsack::setItems(const vector<int> &includedIndicies)
+// Select exactly the items in includedIndicies.
 {
-	for (int i = 0; i < numObjects; i++)
+	Solution items(numObjects);
+
+	for (int i = 0; i < (int)includedIndicies.size(); i++)
 	{
-		unSelect(i);
+		if (includedIndicies[i] < 0 || includedIndicies[i] >= numObjects)
+			throw rangeError("Bad value in knapsack::setItems");
+
+		items.set(includedIndicies[i]);
 	}
 
-	for (int i = 0; i < includedIndicies.size(); i++)
+	setItems(items);
+}
+
+void knapsack::setItems(const Solution &items)
+// Select exactly the items in items, visiting only the items whose selection changes.
+{
+	const vector<unsigned long long> &target = items.getWords();
+
+	for (int w = 0; w < (int)target.size(); w++)
 	{
-		select(includedIndicies[i]);
+		unsigned long long diff = selected.getWords()[w] ^ target[w];
+
+		while (diff != 0)
+		{
+			int i = 64 * w + lowestBit(diff);
+			diff &= diff - 1;
+
+			if (items.test(i))
+				select(i);
+			else
+				unSelect(i);
+		}
 	}
 }
@@ -1,16 +1,27 @@
 // Knapsack class
 // Version f08.1
+#pragma once
+
 #include <iostream>
 #include <vector>
 #include <fstream>
 #include "d_except.h"
+#include "loader.h"
+#include "solution.h"
 
 using namespace std;
 
+// Upper bounds for a partial solution.  The Martello-Toth U2 bound decides the critical item
+// both ways, and the enumerative bound decides every combination of the four items around it,
+// bounding the rest by LP in each case.  Both are integers no larger than the Dantzig LP bound.
+enum boundType { dantzigBound, martelloTothBound, enumerativeBound };
+
 class knapsack
 {
 public:
 	knapsack(ifstream &fin);
+	knapsack(int costLimit, const vector<int> &value, const vector<int> &cost);
+	knapsack(const knapsackData &data);
 	knapsack(const knapsack &);
 	knapsack &operator=(const knapsack &k);
 	int getCost(int) const;
@@ -21,27 +32,46 @@ public:
 	int getCostLimit() const;
 	int getCurrentItem() const;
 	float getPriority(int) const;
-	float bound(int currItem);
+	int bound(int currItem) const;
+	int bound(int currItem, int cost, int value) const;
+	int bound(int currItem, int cost, int value, boundType type) const;
+	int getMinCost(int currItem) const;
+	int fillPrefix(int room, int &fillCost, int &fillValue) const;
 	void nextItem();
 	void printSolution();
 	void select(int);
 	void unSelect(int);
 	bool isSelected(int) const;
 	bool isFathomed(int incumbent);
-	vector<bool> getSelected();
-	vector<int> sort() const;
+	const Solution &getSelected() const;
+	const vector<int> &sort() const;
 	vector<int> getIndicies() const;
-	void setItems(vector<int> includedIndicies);
+	void setItems(const vector<int> &includedIndicies);
+	void setItems(const Solution &items);
 
 private:
 	int numObjects;
 	int costLimit;
 	vector<int> value;
 	vector<int> cost;
-	vector<bool> selected;
+	Solution selected;
 	int totalValue;
 	int totalCost;
 	int currentItem;
-	int partition(vector<int> &items, int left, int right, int pivot) const;
-	void quicksort(vector<int> &items, int left, int right) const;
+
+	// Density order, computed once per instance
+	vector<int> order;
+	vector<int> position;
+	vector<int> prefixCost;
+	vector<int> prefixValue;
+	vector<int> suffixMinCost;
+
+	// Fenwick trees over density positions holding the cost and value of selected items
+	vector<int> selectedCostTree;
+	vector<int> selectedValueTree;
+	int fenwickStep;
+
+	void initializeOrder();
+	void updateSelectedTrees(int i, int sign);
+	long long windowBound(int currItem, int room, int first, int last) const;
 };
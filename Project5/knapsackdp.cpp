@@ -0,0 +1,97 @@
+// File: knapsackdp.cpp
+// Exact knapsack by dynamic programming over the cost limit.  The table is kept one row at a time,
+// and the solution is recovered by divide and conquer (as in Hirschberg's algorithm): the best value
+// for each half of the items is computed for every capacity, the capacity is split where the two
+// halves add up to the optimum, and each half is solved again with its share.  This needs O(W)
+// memory instead of an n x W table, for about twice the O(nW) time of a single pass.
+
+#include <algorithm>
+#include <limits.h>
+
+#include "knapsackdp.h"
+#include "p5a.h"
+
+using namespace std;
+
+namespace
+{
+	void bestValues(const knapsack &k, int first, int last, int capacity, vector<int> &row, vector<int> &scratch)
+	// Set row[c] to the best value of items first..last-1 with cost at most c, for every c <= capacity.
+	{
+		row.assign(capacity + 1, 0);
+		scratch.resize(capacity + 1);
+
+		for (int i = first; i < last; i++)
+		{
+			int c = k.getCost(i);
+			int v = k.getValue(i);
+			if (c > capacity)
+				continue;
+
+			const int *prev = &row[0];
+			int *next = &scratch[0];
+
+			// Separate rows keep the loop free of dependencies so that it vectorizes
+			copy(prev, prev + c, next);
+			for (int w = c; w <= capacity; w++)
+				next[w] = max(prev[w], prev[w - c] + v);
+
+			row.swap(scratch);
+		}
+	}
+
+	void recover(knapsack &k, int first, int last, int capacity)
+	// Select an optimal set of items first..last-1 with total cost at most capacity.
+	{
+		if (last - first == 1)
+		{
+			if (k.getCost(first) <= capacity && k.getValue(first) > 0)
+				k.select(first);
+			return;
+		}
+
+		int middle = first + (last - first) / 2;
+		int split = 0;
+
+		{
+			vector<int> left, right, scratch;
+			bestValues(k, first, middle, capacity, left, scratch);
+			bestValues(k, middle, last, capacity, right, scratch);
+
+			for (int c = 1; c <= capacity; c++)
+				if (left[c] + right[capacity - c] > left[split] + right[capacity - split])
+					split = c;
+		}
+
+		recover(k, first, middle, split);
+		recover(k, middle, last, capacity - split);
+	}
+}
+
+void dynamicKnapsack(knapsack &k)
+// Solve the knapsack problem exactly by dynamic programming in O(nW) time and O(W) memory,
+// where W is the cost limit.  The rows hold W + 1 entries, so W must be below INT_MAX.
+{
+	if (k.getCostLimit() == INT_MAX)
+		throw rangeError("Cost limit too large in dynamicKnapsack");
+
+	for (int i = 0; i < k.getNumObjects(); i++)
+		k.unSelect(i);
+
+	if (k.getNumObjects() > 0)
+		recover(k, 0, k.getNumObjects(), k.getCostLimit());
+}
+
+void exactKnapsack(knapsack &k, int time, long long dpBudget, int rowBudget)
+// Solve the knapsack problem exactly, by dynamic programming when the n x W table has at most
+// dpBudget entries and a row of W + 1 entries at most rowBudget, and by branch and bound
+// otherwise.  dpBudget limits the time, and rowBudget the memory: the recovery keeps three rows
+// at once, so 1 << 24 entries take 192 MB.
+{
+	long long rowEntries = (long long)k.getCostLimit() + 1;
+
+	if (rowEntries <= rowBudget && k.getNumObjects() * rowEntries <= dpBudget)
+		dynamicKnapsack(k);
+	else
+		branchAndBound(k, time);
+}
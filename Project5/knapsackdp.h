@@ -0,0 +1,7 @@
+// Dynamic programming solvers for the knapsack problem
+#pragma once
+
+#include "knapsack.h"
+
+void dynamicKnapsack(knapsack &k);
+void exactKnapsack(knapsack &k, int time, long long dpBudget = 1LL << 32, int rowBudget = 1 << 24);
@@ -0,0 +1,416 @@
+// File: loader.cpp
+// Reads the knapsack.format and color.format inputs without stream extraction.  The file is
+// memory mapped and scanned with a hand-written integer parser that reports the file and line
+// of any malformed entry.  With useCache set, the parsed arrays are also written to a binary
+// sidecar (fileName + ".bin") stamped with the source file's size and modification time; later
+// loads that find a matching sidecar keep it mapped and read the arrays in place, with no parsing
+// and no copy.
+
+#include <fstream>
+#include <limits.h>
+#include <sstream>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "loader.h"
+
+namespace
+{
+	const int cacheVersion = 1;
+
+	struct cacheHeader
+	{
+		char magic[4];
+		int version;
+		long long sourceSize;
+		long long sourceTime;
+		int counts[4];
+	};
+
+	bool sourceStamp(const string &fileName, long long &size, long long &time)
+	// Look up the size and modification time of fileName.
+	{
+		struct stat info;
+		if (stat(fileName.c_str(), &info) != 0)
+			return false;
+
+		size = (long long)info.st_size;
+		time = (long long)info.st_mtime;
+		return true;
+	}
+
+	const char *readCache(const mappedFile &cache, const string &fileName, const char *magic)
+	// Return a pointer to the arrays in cache if it is a current sidecar of fileName, or NULL.
+	{
+		long long size, time;
+		if (cache.size() < (long long)sizeof(cacheHeader) || !sourceStamp(fileName, size, time))
+			return NULL;
+
+		const cacheHeader *header = (const cacheHeader *)cache.begin();
+		if (memcmp(header->magic, magic, 4) != 0 || header->version != cacheVersion ||
+			header->sourceSize != size || header->sourceTime != time)
+			return NULL;
+
+		return cache.begin() + sizeof(cacheHeader);
+	}
+
+	void writeCache(const string &fileName, const char *magic, const int counts[4],
+		const vector<const vector<int> *> &arrays)
+	// Write the sidecar for fileName.  A failure only costs the next run a parse, so it is ignored.
+	{
+		cacheHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, magic, 4);
+		header.version = cacheVersion;
+		if (!sourceStamp(fileName, header.sourceSize, header.sourceTime))
+			return;
+		memcpy(header.counts, counts, sizeof(header.counts));
+
+		ofstream fout((fileName + ".bin").c_str(), ios::binary | ios::trunc);
+		fout.write((const char *)&header, sizeof(header));
+		for (int i = 0; i < (int)arrays.size(); i++)
+			if (!arrays[i]->empty())
+				fout.write((const char *)&(*arrays[i])[0], arrays[i]->size() * sizeof(int));
+	}
+
+	bool fileExists(const string &fileName)
+	{
+		struct stat info;
+		return stat(fileName.c_str(), &info) == 0;
+	}
+}
+
+#ifdef _WIN32
+
+mappedFile::mappedFile(const string &fileName)
+// Map fileName read-only.
+	: data(NULL), length(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(NULL)
+{
+	fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		throw fileOpenError(fileName);
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+		throw fileOpenError(fileName);
+	}
+	length = fileSize.QuadPart;
+
+	// An empty file cannot be mapped, and has nothing to read anyway
+	if (length == 0)
+		return;
+
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle != NULL)
+		data = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+	if (data == NULL)
+	{
+		if (mappingHandle != NULL)
+			CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		throw fileOpenError(fileName);
+	}
+}
+
+mappedFile::~mappedFile()
+{
+	if (data != NULL)
+		UnmapViewOfFile(data);
+	if (mappingHandle != NULL)
+		CloseHandle(mappingHandle);
+	CloseHandle(fileHandle);
+}
+
+#else
+
+mappedFile::mappedFile(const string &fileName)
+// Map fileName read-only.
+	: data(NULL), length(0)
+{
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw fileOpenError(fileName);
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw fileOpenError(fileName);
+	}
+	length = (long long)info.st_size;
+
+	// An empty file cannot be mapped, and has nothing to read anyway
+	if (length > 0)
+	{
+		void *mapping = mmap(NULL, (size_t)length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED)
+		{
+			close(fd);
+			throw fileOpenError(fileName);
+		}
+		madvise(mapping, (size_t)length, MADV_SEQUENTIAL);
+		data = (const char *)mapping;
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+}
+
+mappedFile::~mappedFile()
+{
+	if (data != NULL)
+		munmap((void *)data, (size_t)length);
+}
+
+#endif
+
+const char *mappedFile::begin() const
+{
+	return data;
+}
+
+const char *mappedFile::end() const
+{
+	return data + length;
+}
+
+long long mappedFile::size() const
+{
+	return length;
+}
+
+integerScanner::integerScanner(const char *begin, const char *end, const string &fileName)
+	: p(begin), end(end), fileName(fileName), line(1)
+{
+}
+
+void integerScanner::skipSpace()
+// Advance past whitespace, counting newlines.
+{
+	while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+	{
+		if (*p == '\n')
+			line++;
+		p++;
+	}
+}
+
+void integerScanner::fail(const string &message) const
+// Throw a fileError naming the file and line.
+{
+	ostringstream error;
+	error << fileName << ":" << line << ": " << message;
+	throw fileError(error.str());
+}
+
+int integerScanner::next(const char *what)
+// Read the next integer, described as what in error messages.
+{
+	skipSpace();
+	if (p == end)
+		fail(string("unexpected end of file, expected ") + what);
+
+	bool negative = false;
+	if (*p == '-' || *p == '+')
+	{
+		negative = *p == '-';
+		p++;
+	}
+
+	if (p == end || *p < '0' || *p > '9')
+	{
+		const char *tokenEnd = p;
+		while (tokenEnd != end && *tokenEnd != ' ' && *tokenEnd != '\t' && *tokenEnd != '\n' && *tokenEnd != '\r')
+			tokenEnd++;
+		fail(string("expected ") + what + ", found \"" + string(p, tokenEnd) + "\"");
+	}
+
+	long long result = 0;
+	while (p != end && *p >= '0' && *p <= '9')
+	{
+		result = result * 10 + (*p - '0');
+		if (result > (long long)INT_MAX + 1)
+			fail(string(what) + " is out of range");
+		p++;
+	}
+
+	if (p != end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+		fail(string("unexpected character '") + *p + "' in " + what);
+
+	if (negative)
+		result = -result;
+	if (result > INT_MAX)
+		fail(string(what) + " is out of range");
+
+	return (int)result;
+}
+
+int integerScanner::next(const char *what, int low, int high)
+// Read the next integer and check that it lies in [low, high].
+{
+	int result = next(what);
+	if (result < low || result > high)
+	{
+		ostringstream error;
+		error << what << " " << result << " is outside [" << low << ", " << high << "]";
+		fail(error.str());
+	}
+
+	return result;
+}
+
+void integerScanner::finish()
+// Check that nothing but whitespace is left.
+{
+	skipSpace();
+	if (p != end)
+		fail("unexpected data after the last entry");
+}
+
+const int *knapsackData::getValues() const
+// Return the numObjects values, indexed by object id.
+{
+	if (cache)
+		return (const int *)(cache->begin() + sizeof(cacheHeader));
+	return value.data();
+}
+
+const int *knapsackData::getCosts() const
+// Return the numObjects costs, indexed by object id.
+{
+	if (cache)
+		return (const int *)(cache->begin() + sizeof(cacheHeader)) + numObjects;
+	return cost.data();
+}
+
+const int *colorData::getEdges() const
+// Return the numEdges pairs of endpoints.
+{
+	if (cache)
+		return (const int *)(cache->begin() + sizeof(cacheHeader));
+	return edges.data();
+}
+
+void loadKnapsack(const string &fileName, knapsackData &data, bool useCache)
+// Read a knapsack.format file into data.  Each object id must appear exactly once.
+{
+	data.cache.reset();
+	if (useCache && fileExists(fileName + ".bin"))
+	{
+		shared_ptr<const mappedFile> cache(new mappedFile(fileName + ".bin"));
+		const char *arrays = readCache(*cache, fileName, "KNP1");
+		if (arrays != NULL)
+		{
+			const cacheHeader *header = (const cacheHeader *)cache->begin();
+			int n = header->counts[0];
+			if (n >= 0 && cache->size() == (long long)sizeof(cacheHeader) + 2LL * n * (long long)sizeof(int))
+			{
+				data.numObjects = n;
+				data.costLimit = header->counts[1];
+				data.value.clear();
+				data.cost.clear();
+				data.cache = cache;
+				return;
+			}
+		}
+	}
+
+	mappedFile file(fileName);
+	integerScanner scan(file.begin(), file.end(), fileName);
+
+	int n = scan.next("number of objects", 0, INT_MAX);
+
+	// Each object takes at least five characters, which bounds n before anything is allocated
+	if (n > file.size() / 5)
+		scan.fail("the file is too short to hold the number of objects given");
+	data.numObjects = n;
+	data.costLimit = scan.next("cost bound", 0, INT_MAX);
+	data.value.assign(n, 0);
+	data.cost.assign(n, 0);
+
+	vector<bool> seen(n, false);
+	for (int i = 0; i < n; i++)
+	{
+		int j = scan.next("object id", 0, n - 1);
+		if (seen[j])
+		{
+			ostringstream error;
+			error << "object id " << j << " appears twice";
+			scan.fail(error.str());
+		}
+		seen[j] = true;
+		data.value[j] = scan.next("object value", 0, INT_MAX);
+		data.cost[j] = scan.next("object cost", 0, INT_MAX);
+	}
+	scan.finish();
+
+	if (useCache)
+	{
+		int counts[4] = { data.numObjects, data.costLimit, 0, 0 };
+		vector<const vector<int> *> arrays;
+		arrays.push_back(&data.value);
+		arrays.push_back(&data.cost);
+		writeCache(fileName, "KNP1", counts, arrays);
+	}
+}
+
+void loadColoring(const string &fileName, colorData &data, bool useCache)
+// Read a color.format file into data.
+{
+	data.cache.reset();
+	if (useCache && fileExists(fileName + ".bin"))
+	{
+		shared_ptr<const mappedFile> cache(new mappedFile(fileName + ".bin"));
+		const char *arrays = readCache(*cache, fileName, "CLR1");
+		if (arrays != NULL)
+		{
+			const cacheHeader *header = (const cacheHeader *)cache->begin();
+			int e = header->counts[2];
+			if (e >= 0 && cache->size() == (long long)sizeof(cacheHeader) + 2LL * e * (long long)sizeof(int))
+			{
+				data.numColors = header->counts[0];
+				data.numNodes = header->counts[1];
+				data.numEdges = e;
+				data.edges.clear();
+				data.cache = cache;
+				return;
+			}
+		}
+	}
+
+	mappedFile file(fileName);
+	integerScanner scan(file.begin(), file.end(), fileName);
+
+	data.numColors = scan.next("number of colors", 0, INT_MAX);
+	data.numNodes = scan.next("number of nodes", 0, INT_MAX);
+	data.numEdges = scan.next("number of edges", 0, INT_MAX / 2);
+
+	// Each edge takes at least three characters
+	if (data.numEdges > file.size() / 3)
+		scan.fail("the file is too short to hold the number of edges given");
+	data.edges.resize(2 * (size_t)data.numEdges);
+
+	for (int i = 0; i < 2 * data.numEdges; i++)
+		data.edges[i] = scan.next("edge endpoint", 0, data.numNodes - 1);
+	scan.finish();
+
+	if (useCache)
+	{
+		int counts[4] = { data.numColors, data.numNodes, data.numEdges, 0 };
+		vector<const vector<int> *> arrays;
+		arrays.push_back(&data.edges);
+		writeCache(fileName, "CLR1", counts, arrays);
+	}
+}
@@ -0,0 +1,80 @@
+// Instance loader for the knapsack and graph coloring inputs
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "d_except.h"
+
+using namespace std;
+
+// A read-only view of a whole file, memory mapped where the platform allows.
+class mappedFile
+{
+public:
+	mappedFile(const string &fileName);
+	~mappedFile();
+	const char *begin() const;
+	const char *end() const;
+	long long size() const;
+
+private:
+	const char *data;
+	long long length;
+#ifdef _WIN32
+	void *fileHandle;
+	void *mappingHandle;
+#endif
+
+	mappedFile(const mappedFile &);
+	mappedFile &operator=(const mappedFile &);
+};
+
+// Reads whitespace-separated integers from a buffer, tracking the line number for error messages.
+class integerScanner
+{
+public:
+	integerScanner(const char *begin, const char *end, const string &fileName);
+	int next(const char *what);
+	int next(const char *what, int low, int high);
+	void finish();
+	void fail(const string &message) const;
+
+private:
+	const char *p;
+	const char *end;
+	string fileName;
+	int line;
+
+	void skipSpace();
+};
+
+// The arrays of a loaded instance live either in the vectors or, when they were read from a cache
+// sidecar, in place in its mapping, which the struct and its copies keep alive.  Read them
+// through the get functions, which work either way.
+struct knapsackData
+{
+	int numObjects;
+	int costLimit;
+	vector<int> value;
+	vector<int> cost;
+	shared_ptr<const mappedFile> cache;
+
+	const int *getValues() const;
+	const int *getCosts() const;
+};
+
+struct colorData
+{
+	int numColors;
+	int numNodes;
+	int numEdges;
+	vector<int> edges;  // numEdges pairs of endpoints
+	shared_ptr<const mappedFile> cache;
+
+	const int *getEdges() const;
+};
+
+void loadKnapsack(const string &fileName, knapsackData &data, bool useCache = false);
+void loadColoring(const string &fileName, colorData &data, bool useCache = false);
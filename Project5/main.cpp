@@ -4,6 +4,7 @@
 #include <iostream>
 #include "p5a.h"
 #include "p5b.h"
+#include "benchmark.h"
 
 int main() {
 	// Run p5a.cpp/p5b.cpp
@@ -16,7 +17,7 @@ int main() {
 	{
 		do
 		{
-			std::cout << "[1] knapsack \n[2] graph coloring \n[3] quit\n";
+			std::cout << "[1] knapsack \n[2] graph coloring \n[3] knapsack benchmark \n[4] quit\n";
 			std::cout << "Select which project problem to run: ";
 			std::cin >> num;
 
@@ -24,11 +25,12 @@ int main() {
 			{
 			case 1: knapsackRun(); break;
 			case 2: graphColoring(); break;
-			case 3: exit(0);
+			case 3: benchmarkRun(); break;
+			case 4: exit(0);
 			default: 
-				std::cout << "Please select correct input. [1/2/3]";
+				std::cout << "Please select correct input. [1/2/3/4]";
 			}
-		} while (num != 1 && num != 2);
+		} while (num != 1 && num != 2 && num != 3);
 
 		do
 		{
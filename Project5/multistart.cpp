@@ -0,0 +1,130 @@
+// File: multistart.cpp
+// Multi-start local search.  Every start locks a small random kernel of items into the
+// knapsack, fills the rest with a randomized greedy pass in density order, and runs steepest
+// descent on the items outside the kernel.  Starts are spread over several threads and the
+// best result is kept.
+//
+// Start r draws all of its random numbers from its own randomNumber stream, seeded from the
+// run's seed and r, so a start does the same work whichever thread runs it.  Because the kernel
+// never leaves the knapsack, the bound of the kernel alone caps what a start can reach, and a
+// start is abandoned before its search when that bound is below the best value found so far.
+// An abandoned start could never have won, and ties go to the lowest start number, so the
+// result depends only on the seed and number of starts, not on thread timing.
+
+#include <atomic>
+#include <limits.h>
+#include <mutex>
+#include <thread>
+
+#include "anytime.h"
+#include "d_random.h"
+#include "multistart.h"
+#include "neighborhood.h"
+#include "searchstats.h"
+#include "tabu.h"
+
+using namespace std;
+
+namespace
+{
+	struct multiStartShared
+	{
+		const knapsack *k;
+		int numStarts;
+		long seed;
+
+		atomic<int> bestValue;
+		mutex bestLock;
+		int bestStart;
+		Solution bestItems;
+	};
+
+	void runStart(multiStartShared &shared, knapsack &k, int start)
+	// Run one start on k, the calling thread's own copy of the instance.
+	{
+		randomNumber random(streamSeed(shared.seed, start));
+		int numObjects = k.getNumObjects();
+
+		k.setItems(Solution(numObjects));
+
+		// Lock a kernel of random items that fit
+		int kernelSize = max(1, min(8, numObjects / 16));
+		tabuList locked(numObjects, kernelSize, kernelSize);
+		for (int tries = 0; tries < 4 * kernelSize && k.getSelected().count() < kernelSize; tries++)
+		{
+			int item = (int)random.random(numObjects);
+			if (!k.isSelected(item) && k.getCost() + k.getCost(item) <= k.getCostLimit())
+			{
+				k.select(item);
+				locked.add(item);
+			}
+		}
+
+		if (k.bound(0) < shared.bestValue.load(memory_order_relaxed))
+			return;
+
+		// Randomized greedy fill: each item that fits is skipped one time in ten
+		const vector<int> &items = k.sort();
+		for (int i = 0; i < numObjects; i++)
+			if (!k.isSelected(items[i]) && k.getCost() + k.getCost(items[i]) <= k.getCostLimit() && random.random(10) != 0)
+				k.select(items[i]);
+
+		// Steepest descent that never moves a kernel item
+		Neighborhood neighborhood(k);
+		Move best = neighborhood.bestMove(locked, INT_MAX);
+		while (best.type != noMove && best.delta > 0)
+		{
+			STAT_ADD(iterations, 1);
+			neighborhood.apply(best);
+			best = neighborhood.bestMove(locked, INT_MAX);
+		}
+
+		lock_guard<mutex> lock(shared.bestLock);
+		if (k.getValue() > shared.bestValue.load(memory_order_relaxed) ||
+			(k.getValue() == shared.bestValue.load(memory_order_relaxed) && start < shared.bestStart))
+		{
+			if (k.getValue() > shared.bestValue.load(memory_order_relaxed))
+				STAT_INCUMBENT(k.getValue());
+			shared.bestValue.store(k.getValue(), memory_order_relaxed);
+			shared.bestStart = start;
+			shared.bestItems = k.getSelected();
+		}
+	}
+
+	void runStarts(multiStartShared &shared, int thread, int numThreads)
+	// Run starts thread, thread + numThreads, thread + 2 numThreads, ...
+	{
+		knapsack k(*shared.k);
+
+		for (int start = thread; start < shared.numStarts; start += numThreads)
+			runStart(shared, k, start);
+	}
+}
+
+void multiStartSearch(knapsack &k, int numStarts, int numThreads, long seed)
+// Run numStarts randomized local searches on numThreads threads and leave the best result in k.
+// The result is the same for a given seed and number of starts.
+{
+	if (numThreads < 1)
+		numThreads = 1;
+
+	multiStartShared shared;
+	shared.k = &k;
+	shared.numStarts = numStarts;
+	shared.seed = seed;
+	shared.bestValue = 0;
+	shared.bestStart = numStarts;
+	shared.bestItems = Solution(k.getNumObjects());
+
+	vector<thread> threads;
+	for (int i = 1; i < numThreads; i++)
+		threads.push_back(thread(runStarts, ref(shared), i, numThreads));
+
+	runStarts(shared, 0, numThreads);
+
+	for (int i = 0; i < (int)threads.size(); i++)
+		threads[i].join();
+
+	if (shared.bestStart < numStarts)
+		k.setItems(shared.bestItems);
+}
@@ -0,0 +1,6 @@
+// Parallel multi-start local search for the knapsack problem
+#pragma once
+
+#include "knapsack.h"
+
+void multiStartSearch(knapsack &k, int numStarts, int numThreads, long seed);
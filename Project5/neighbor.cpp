@@ -1,12 +1,22 @@
+#include <utility>
+
 #include "neighbor.h"
 
 Neighbor::Neighbor()
-{}
+{
+	value = 0;
+}
+
+Neighbor::Neighbor(int value, const Solution &items)
+{
+	this->value = value;
+	this->items = items;
+}
 
-Neighbor::Neighbor(int value, vector<int>indicies)
+Neighbor::Neighbor(int value, Solution &&items)
 {
 	this->value = value;
-	this->indicies = indicies;
+	this->items = std::move(items);
 }
 
 int Neighbor::getValue() const
@@ -14,7 +24,14 @@ int Neighbor::getValue() const
 	return value;
 }
 
-vector<int> Neighbor::getIndicies() const
+const Solution &Neighbor::getItems() const
+{
+	return items;
+}
+
+void Neighbor::setItems(int value, const Solution &items)
+// Replace the neighbor, reusing its storage.
 {
-	return indicies;
-}
\ No newline at end of file
+	this->value = value;
+	this->items = items;
+}
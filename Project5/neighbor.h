@@ -1,3 +1,5 @@
+#pragma once
+
 #include <iostream>
 #include <limits.h>
 #include <list>
@@ -9,19 +11,22 @@
 
 #include "d_except.h"
 #include "d_matrix.h"
+#include "solution.h"
 
 using namespace std;
 
-// Use this class for knapsack (not sure about coloring) to parametize a neighbor of a point by its value and indicies.
+// Use this class for knapsack (not sure about coloring) to parametize a neighbor of a point by its value and items.
 class Neighbor
 {
 public:
 	Neighbor();
-	Neighbor(int value, vector<int> indicies);
+	Neighbor(int value, const Solution &items);
+	Neighbor(int value, Solution &&items);
 	int getValue() const;
-	vector<int> getIndicies() const;
+	const Solution &getItems() const;
+	void setItems(int value, const Solution &items);
 
 private:
 	int value;
-	vector<int> indicies;
+	Solution items;
 };
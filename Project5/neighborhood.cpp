@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <limits.h>
+
+#include "neighborhood.h"
+#include "searchstats.h"
+
+namespace
+{
+	struct costLess
+	{
+		const knapsack *k;
+		bool operator()(int a, int b) const { return k->getCost(a) < k->getCost(b); }
+	};
+
+	bool isTabu(const tabuList *tabu, int item)
+	{
+		return tabu != 0 && tabu->isTabu(item);
+	}
+}
+
+Neighborhood::Neighborhood(knapsack &k) : k(k)
+// Build the free-item tree for the current contents of k.
+{
+	int n = k.getNumObjects();
+
+	byCost.resize(n);
+	for (int i = 0; i < n; i++)
+		byCost[i] = i;
+
+	costLess less = { &k };
+	stable_sort(byCost.begin(), byCost.end(), less);
+
+	costRank.resize(n);
+	sortedCost.resize(n);
+	for (int r = 0; r < n; r++)
+	{
+		costRank[byCost[r]] = r;
+		sortedCost[r] = k.getCost(byCost[r]);
+	}
+
+	numLeaves = 1;
+	while (numLeaves < n)
+		numLeaves *= 2;
+
+	freeBest.assign(2 * numLeaves, -1);
+	for (int r = 0; r < n; r++)
+		if (!k.isSelected(byCost[r]))
+			freeBest[numLeaves + r] = byCost[r];
+
+	for (int node = numLeaves - 1; node > 0; node--)
+		freeBest[node] = better(freeBest[2 * node], freeBest[2 * node + 1]);
+
+	// Zobrist keys from a fixed splitmix64 sequence, so hashes are the same on every run
+	unsigned long long state = 0;
+	keys.resize(n);
+	hash = 0;
+	for (int i = 0; i < n; i++)
+	{
+		unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		keys[i] = z ^ (z >> 31);
+
+		if (k.isSelected(i))
+			hash ^= keys[i];
+	}
+}
+
+int Neighborhood::better(int a, int b) const
+// Return whichever of items a and b is more valuable, where -1 stands for no item.
+{
+	if (a == -1 || (b != -1 && k.getValue(b) > k.getValue(a)))
+		return b;
+	return a;
+}
+
+int Neighborhood::bestFree(int maxCost) const
+// Return the most valuable unselected item that costs at most maxCost, or -1 if there is none.
+{
+	int best = -1;
+	int left = numLeaves;
+	int right = numLeaves + (int)(upper_bound(sortedCost.begin(), sortedCost.end(), maxCost) - sortedCost.begin());
+
+	for (; left < right; left /= 2, right /= 2)
+	{
+		if (left & 1)
+			best = better(best, freeBest[left++]);
+		if (right & 1)
+			best = better(best, freeBest[--right]);
+	}
+
+	return best;
+}
+
+int Neighborhood::getRefillValue(int item) const
+// Return the value of the unselected items that a drop of item would make room for, packed
+// in density order until the first one that does not fit.
+{
+	int fillCost;
+	int fillValue;
+	k.fillPrefix(k.getCostLimit() - k.getCost() + k.getCost(item), fillCost, fillValue);
+
+	return fillValue;
+}
+
+Move Neighborhood::bestMove() const
+// Return the move with the largest change in value, or a move of type noMove if there are none.
+{
+	return findBest(0, INT_MAX);
+}
+
+Move Neighborhood::bestMove(const tabuList &tabu, int aspiration) const
+// Return the move with the largest change in value that does not add or remove a tabu item,
+// unless it would raise the knapsack value above aspiration.  Returns a move of type noMove
+// if there are none.
+{
+	return findBest(&tabu, aspiration);
+}
+
+Move Neighborhood::findBest(const tabuList *tabu, int aspiration) const
+// Return the best move allowed by tabu, which may be null.
+{
+	int residual = k.getCostLimit() - k.getCost();
+	int value = k.getValue();
+	Move best = { noMove, -1, -1, INT_MIN };
+
+	// One add, and a drop, swap and refill for each selected item
+	STAT_ADD(neighborsEvaluated, 1 + 3 * k.getSelected().count());
+
+	int in = bestFree(residual);
+	if (in != -1 && (!isTabu(tabu, in) || value + k.getValue(in) > aspiration))
+	{
+		Move m = { addMove, in, -1, k.getValue(in) };
+		best = m;
+	}
+
+	for (int out = 0; out < k.getNumObjects(); out++)
+	{
+		if (!k.isSelected(out))
+			continue;
+
+		bool allowed = !isTabu(tabu, out);
+
+		if (-k.getValue(out) > best.delta && allowed)
+		{
+			Move m = { dropMove, -1, out, -k.getValue(out) };
+			best = m;
+		}
+
+		in = bestFree(residual + k.getCost(out));
+		int delta = in == -1 ? INT_MIN : k.getValue(in) - k.getValue(out);
+		if (delta > best.delta && ((allowed && !isTabu(tabu, in)) || value + delta > aspiration))
+		{
+			Move m = { swapMove, in, out, delta };
+			best = m;
+		}
+
+		delta = getRefillValue(out) - k.getValue(out);
+		if (delta > best.delta && (allowed || value + delta > aspiration))
+		{
+			Move m = { refillMove, -1, out, delta };
+			best = m;
+		}
+	}
+
+	return best;
+}
+
+void Neighborhood::apply(const Move &m)
+// Make move m on the knapsack.
+{
+	changed.clear();
+
+	switch (m.type)
+	{
+	case addMove:
+		select(m.in);
+		break;
+	case dropMove:
+		unSelect(m.out);
+		break;
+	case swapMove:
+		unSelect(m.out);
+		select(m.in);
+		break;
+	case refillMove:
+	{
+		int fillCost;
+		int fillValue;
+		int length = k.fillPrefix(k.getCostLimit() - k.getCost() + k.getCost(m.out), fillCost, fillValue);
+		const vector<int> &items = k.sort();
+
+		unSelect(m.out);
+		for (int i = 0; i < length; i++)
+			if (items[i] != m.out && !k.isSelected(items[i]))
+				select(items[i]);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+unsigned long long Neighborhood::getHash() const
+// Return the Zobrist hash of the current solution.
+{
+	return hash;
+}
+
+const vector<int> &Neighborhood::getChanged() const
+// Return the items added or removed by the last move applied.
+{
+	return changed;
+}
+
+void Neighborhood::select(int item)
+{
+	k.select(item);
+	update(item);
+}
+
+void Neighborhood::unSelect(int item)
+{
+	k.unSelect(item);
+	update(item);
+}
+
+void Neighborhood::update(int item)
+// Bring the free-item tree and hash up to date after item was selected or unselected.
+{
+	int node = numLeaves + costRank[item];
+	freeBest[node] = k.isSelected(item) ? -1 : item;
+	hash ^= keys[item];
+	changed.push_back(item);
+
+	for (node /= 2; node > 0; node /= 2)
+		freeBest[node] = better(freeBest[2 * node], freeBest[2 * node + 1]);
+}
@@ -0,0 +1,60 @@
+// Knapsack neighborhood class
+#pragma once
+
+#include <vector>
+
+#include "knapsack.h"
+#include "tabu.h"
+
+using namespace std;
+
+enum moveType { noMove, addMove, dropMove, swapMove, refillMove };
+
+// A local search move and the change in knapsack value it would make.
+// in is the item added by an add or swap, out the item removed by a drop, swap or refill.
+struct Move
+{
+	moveType type;
+	int in;
+	int out;
+	int delta;
+};
+
+// Scores and applies local search moves on a knapsack without copying it.
+// The residual capacity comes from the knapsack's running totals, and the unselected items are
+// kept in a segment tree over their cost order that answers "most valuable unselected item costing
+// at most c" in O(log n).  Each add, drop, 1-1 swap and drop-then-refill move is scored in O(log n)
+// without changing the knapsack, and only the move chosen is applied.
+// Adds and swaps only consider the most valuable unselected item that fits, so a tabu search
+// passes over them when that item is tabu.
+// The solution also carries a Zobrist hash (an xor of a random key per selected item), kept up
+// to date as moves are applied, and the items changed by the last move are remembered.
+class Neighborhood
+{
+public:
+	Neighborhood(knapsack &k);
+	Move bestMove() const;
+	Move bestMove(const tabuList &tabu, int aspiration) const;
+	int getRefillValue(int item) const;
+	void apply(const Move &m);
+	unsigned long long getHash() const;
+	const vector<int> &getChanged() const;
+
+private:
+	knapsack &k;
+	vector<int> byCost;
+	vector<int> costRank;
+	vector<int> sortedCost;
+	vector<int> freeBest;
+	int numLeaves;
+	vector<unsigned long long> keys;
+	unsigned long long hash;
+	vector<int> changed;
+
+	Move findBest(const tabuList *tabu, int aspiration) const;
+	int better(int a, int b) const;
+	int bestFree(int maxCost) const;
+	void select(int item);
+	void unSelect(int item);
+	void update(int item);
+};
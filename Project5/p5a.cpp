@@ -6,54 +6,117 @@
 
 using namespace std;
 
-void branchAndBound(knapsack &k, int time)
-// Branch and bound algorithm to solve the knapsack problem.
+void branchAndBound(knapsack &k, int time, bbStrategy strategy, int maxNodes, boundType bound, int boundDepth,
+	size_t dominanceBytes)
+// Branch and bound for at most time seconds.
+{
+	searchControl control((double)time);
+	branchAndBound(k, control, strategy, maxNodes, bound, boundDepth, dominanceBytes);
+}
+
+void branchAndBound(knapsack &k, searchControl &control, bbStrategy strategy, int maxNodes, boundType bound, int boundDepth,
+	size_t dominanceBytes, const knapsackCallback &onImprove, dominanceStats *stats)
+// Branch and bound algorithm to solve the knapsack problem, until the search space is exhausted
+// or control stops it.
 // Branching is binary: one branch to take the "next" object, one branch to skip it
+// Nodes are bbNodes that refer to k for the item data, and the items taken on the way to a node
+// are only collected from the decision trail when it becomes the incumbent.
+// Open nodes wait on a stack (depth first) or in a priority queue by bound (best first).  Once the
+// queue holds maxNodes nodes, new children go on the stack instead, so the search dives depth first
+// from the current node until the stack empties and then goes back to the queue.
+// Children of nodes shallower than boundDepth are bounded with bound, and the rest with the
+// Dantzig bound; the stronger bounds cost more per node, and pay off most near the root.
+// With dominanceBytes > 0, a dominanceTable of that size prunes nodes whose (depth, cost) state
+// has already been expanded with at least their value, and stats, if set, gets its counts.
+// onImprove, if set, is called with each new incumbent.
 {
-	clock_t startTime = clock();
-	knapsack incumbent(k);
-	vector<int> items = k.sort();
-	stack<knapsack> nodes;
-	k.bound(items[k.getCurrentItem()]);
-	nodes.push(k);
-
-	while (!nodes.empty() && (clock() - startTime) / CLOCKS_PER_SEC < time)
+	const vector<int> &items = k.sort();
+	decisionTrail trail;
+	stack<bbNode, vector<bbNode> > dive;
+	priority_queue<bbNode, vector<bbNode>, bbNodeLess> best;
+	dominanceTable dominance(dominanceBytes);
+
+	int incumbentValue = k.getValue();
+	vector<int> incumbentItems = k.getIndicies();
+	bool diving = strategy != bestFirst;
+
+	bbNode root = { 0, 0, 0, k.bound(0, 0, 0), decisionTrail::none };
+	if (diving)
+		dive.push(root);
+	else
+		best.push(root);
+
+	while ((!dive.empty() || !best.empty()) && !control.stopped())
 	{
-		knapsack current = nodes.top();
-		nodes.pop();
-		bool isFathomed = current.isFathomed(incumbent.getValue());
+		bbNode current;
+		if (!dive.empty())
+		{
+			current = dive.top();
+			dive.pop();
+		}
+		else
+		{
+			current = best.top();
+			best.pop();
+		}
 
-		// If node is fathomed, legal, and better than incumbent, it becomes the new incumbent
-		if (isFathomed && current.getCost() <= current.getCostLimit() && current.getValue() > incumbent.getValue())
+		// Every node is a legal solution, so a better one becomes the new incumbent
+		if (current.value > incumbentValue)
 		{
-			incumbent = current;
+			incumbentValue = current.value;
+			trail.getItems(current.trail, incumbentItems);
+			STAT_INCUMBENT(incumbentValue);
+
+			if (onImprove)
+				onImprove(incumbentValue, toSolution(k, incumbentItems));
 		}
-		// If node is fathomed and not new incumbent, ignore it
-		// If node is not fathomed, branch on next item
-		else if (!isFathomed)
+
+		if (!isFathomed(k, current, incumbentValue) && !(dominanceBytes > 0 && dominance.dominated(current)))
 		{
-			int item = items[current.getCurrentItem()];
-			knapsack yes(current);
-			knapsack no(current);
+			STAT_ADD(nodesExpanded, 1);
+			STAT_MAX(maxSearchDepth, current.depth);
+			STAT_MAX(maxOpenNodes, dive.size() + best.size() + 1);
 
-			yes.select(item);
-			yes.nextItem();
-			no.nextItem();
+			bbNode children[2];
+			boundType type = current.depth < boundDepth ? bound : dantzigBound;
+			int numChildren = branch(k, items, trail, current, incumbentValue, children, type);
 
-			if (yes.bound(yes.getCurrentItem()) >= no.bound(no.getCurrentItem()))
+			for (int i = 0; i < numChildren; i++)
 			{
-				nodes.push(no);
-				nodes.push(yes);
+				if (diving || (int)best.size() >= maxNodes)
+					dive.push(children[i]);
+				else
+					best.push(children[i]);
 			}
-			else
+		}
+		else if (strategy == hybrid && diving && !incumbentItems.empty())
+		{
+			// The first dive has ended with an incumbent, so switch to best first
+			diving = false;
+			while (!dive.empty())
 			{
-				nodes.push(yes);
-				nodes.push(no);
+				best.push(dive.top());
+				dive.pop();
 			}
 		}
+
+		trail.release(current.trail);
 	}
 
-	k = incumbent;
+	if (stats != NULL)
+		*stats = dominance.getStats();
+
+	k.setItems(incumbentItems);
+}
+
+Solution toSolution(const knapsack &k, const vector<int> &items)
+// Return the set of the given item numbers.
+{
+	Solution s(k.getNumObjects());
+	for (int i = 0; i < (int)items.size(); i++)
+		s.set(items[i]);
+
+	return s;
 }
 
 void greedyKnapsack(knapsack &k)
@@ -61,7 +124,7 @@ void greedyKnapsack(knapsack &k)
 {
 	int limit = k.getCostLimit();
 	int cost = 0;
-	vector<int> items = k.sort();
+	const vector<int> &items = k.sort();
 
 	// The first item in this list now contains the item number of the highest priority knapsack item
 
@@ -106,109 +169,131 @@ Neighbor greedyKnapsackN(knapsack &k)
 		}
 	}
 
-	return Neighbor(k.getValue(), k.getIndicies());
+	return Neighbor(k.getValue(), k.getSelected());
 }
 
 
-Neighbor greedyKnapsackN(knapsack &k, vector<int> indicies, int j)
+void steepestDescent(knapsack &k)
+// Steepest descent from a greedy fill.  Each iteration scores every add, drop, swap and
+// drop-then-refill move with a Neighborhood and applies the best one, until none improves.
 {
-	int limit = k.getCostLimit();
-	//int cost = 0;
-	//vector<int> items = k.sort();
+	greedyKnapsackN(k);
 
-	k.setItems(indicies);
-	k.unSelect(j);
+	Neighborhood neighborhood(k);
+	Move best = neighborhood.bestMove();
 
-	// The first item in this list now contains the item number of the highest priority knapsack item
-
-	for (int i = 0; i < k.getNumObjects(); i++)
+	while (best.delta > 0)
 	{
-		/*
-		int item = items[i];
-
-		if (cost + k.getCost(item) <= limit)
-		{
-			k.select(item);
-			cost += k.getCost(item);
-		}
-		*/
-
-		if (!k.isSelected(i) && i != j && k.getCost() + k.getCost(i) <= k.getCostLimit())
-		{
-			k.select(i);
-		}
+		STAT_ADD(iterations, 1);
+		neighborhood.apply(best);
+		best = neighborhood.bestMove();
 	}
-
-	return Neighbor(k.getValue(), k.getIndicies());
 }
 
-Neighbor bestNeighbor(knapsack &k, Neighbor &currentNeighbor)
+void tabuSearch(knapsack &k, int time, int maxIterations)
+// Tabu search for at most time seconds or maxIterations iterations.
 {
-	Neighbor newNeighbor;
-	Neighbor bestNeighbor = currentNeighbor;
-
-	vector<int> indicies(currentNeighbor.getIndicies());
-
-	for (int i = 0; i < indicies.size(); i++)
-	{
-		// Greedy knapsack with current set of items
-		newNeighbor = greedyKnapsackN(k, indicies, indicies[i]);
-
-		if (newNeighbor.getValue() > bestNeighbor.getValue())
-		{
-			bestNeighbor = newNeighbor;
-		}
-	}
-
-	return bestNeighbor;
+	// An iteration scans the whole neighborhood, so the clock is cheap enough to read every time
+	searchControl control((double)time, NULL, 1);
+	tabuSearch(k, control, maxIterations);
 }
 
-Neighbor bestNeighborTabu(knapsack &k, Neighbor &currentNeighbor, vector<int> &tabuIndicies)
+void tabuSearch(knapsack &k, searchControl &control, int maxIterations, const knapsackCallback &onImprove)
+// Tabu search from a greedy fill, for at most maxIterations iterations or until control stops it.
+// Each iteration applies the best move that does not touch an item moved in the last tenure
+// moves, unless it beats the best solution found so far (aspiration).  The tenure grows when
+// the solution hash shows the search revisiting a solution, and shrinks back slowly otherwise.
+// After a long run without a new best solution the search diversifies by dropping the
+// selected items that have spent the most iterations in the knapsack.
+// onImprove, if set, is called with each new best solution.
 {
-	Neighbor newNeighbor;
-	Neighbor bestNeighbor = currentNeighbor;
+	int numObjects = k.getNumObjects();
+
+	greedyKnapsackN(k);
+
+	Neighborhood neighborhood(k);
+	Neighbor best(k.getValue(), k.getSelected());
 
-	vector<int> indicies(currentNeighbor.getIndicies());
+	int minTenure = max(1, min(7, numObjects / 4));
+	int maxTenure = max(minTenure, numObjects / 2);
+	tabuList tabu(numObjects, maxTenure, minTenure);
+	visitedTable visited(16);
+	// The iterations each item has spent selected are frequency[i], plus the iterations since
+	// selectedSince[i] while it is still selected, so only the items a move flips are touched
+	vector<long long> frequency(numObjects, 0);
+	vector<int> selectedSince(numObjects, 0);
 
-	int tabuIndex = -1;
+	vector<pair<long long, int> > ranked;
+	int stallLimit = max(100, 2 * numObjects);
+	int sinceBest = 0;
+	int sinceCycle = 0;
 
-	for (int i = 0; i < indicies.size(); i++)
+	for (int iteration = 0; iteration < maxIterations && !control.stopped(); iteration++)
 	{
-		newNeighbor = greedyKnapsackN(k, indicies, indicies[i]);
+		STAT_ADD(iterations, 1);
+		Move move = neighborhood.bestMove(tabu, best.getValue());
 
-		if (newNeighbor.getValue() > bestNeighbor.getValue())
+		if (move.type == noMove)
+			tabu.add(-1);
+		else
 		{
-			bestNeighbor = newNeighbor;
+			neighborhood.apply(move);
+
+			const vector<int> &changed = neighborhood.getChanged();
+			for (int i = 0; i < (int)changed.size(); i++)
+			{
+				tabu.add(changed[i]);
+				if (k.isSelected(changed[i]))
+					selectedSince[changed[i]] = iteration;
+				else
+					frequency[changed[i]] += iteration - selectedSince[changed[i]];
+			}
 		}
-	}
 
-	if (tabuIndex != -1)
-	{
-		tabuIndicies.push_back(tabuIndex);
-	}
+		if (k.getValue() > best.getValue())
+		{
+			best.setItems(k.getValue(), k.getSelected());
+			STAT_INCUMBENT(best.getValue());
 
-	return bestNeighbor;
-}
+			if (onImprove)
+				onImprove(best.getValue(), best.getItems());
+			sinceBest = 0;
+		}
+		else
+			sinceBest++;
 
-void steepestDescent(knapsack &k)  
-{
-	k.sort();
+		// Revisiting a solution means the tenure is too short to escape this region
+		if (visited.visit(neighborhood.getHash()))
+		{
+			tabu.setTenure(min(maxTenure, tabu.getTenure() + 1 + tabu.getTenure() / 4));
+			sinceCycle = 0;
+		}
+		else if (++sinceCycle % 100 == 0 && tabu.getTenure() > minTenure)
+			tabu.setTenure(tabu.getTenure() - 1);
 
-	vector<int> indicies;
-	Neighbor currentNeighbor(0, indicies);
+		if (sinceBest >= stallLimit)
+		{
+			// Drop the most frequently selected tenth of the knapsack and make those items tabu
+			ranked.clear();
+			for (int i = 0; i < numObjects; i++)
+				if (k.isSelected(i))
+					ranked.push_back(make_pair(frequency[i] + iteration + 1 - selectedSince[i], i));
 
-	Neighbor nextNeighbor = greedyKnapsackN(k);
+			std::sort(ranked.rbegin(), ranked.rend());
 
-	while (currentNeighbor.getValue() < nextNeighbor.getValue())
-	{
-		currentNeighbor = nextNeighbor;
+			for (int i = 0; i < (int)ranked.size() && i < max(1, (int)ranked.size() / 10); i++)
+			{
+				Move drop = { dropMove, -1, ranked[i].second, -k.getValue(ranked[i].second) };
+				neighborhood.apply(drop);
+				tabu.add(drop.out);
+				frequency[drop.out] += iteration + 1 - selectedSince[drop.out];
+			}
 
-		// Use only 1 of these to implement basic steepestDescent or with tabu
-		nextNeighbor = bestNeighbor(k, currentNeighbor);
-		//nextNeighbor = bestNeighborTabu(k, currentNeighbor, indicies);
+			sinceBest = 0;
+		}
 	}
 
-	k.setItems(currentNeighbor.getIndicies());
+	k.setItems(best.getItems());
 }
 
 void knapsackOutput(knapsack & k)
@@ -224,19 +309,17 @@ void knapsackOutput(knapsack & k)
 	myfile << "Total cost: " << k.getCost() << endl;
 
 	// Print out objects in the solution
-	for (int i = 0; i < k.getNumObjects(); i++)
+	const Solution &items = k.getSelected();
+	for (int i = items.first(); i != -1; i = items.next(i))
 	{
-		if (k.isSelected(i))
+		// Some unnecessary formatting to make output file look nicer
+		if (i < 10)
 		{
-			// Some unnecessary formatting to make output file look nicer
-			if (i < 10)
-			{
-				myfile << i << "   " << k.getValue(i) << " " << k.getCost(i) << endl;
-			}
-			else
-			{
-				myfile << i << "  " << k.getValue(i) << " " << k.getCost(i) << endl;
-			}
+			myfile << i << "   " << k.getValue(i) << " " << k.getCost(i) << endl;
+		}
+		else
+		{
+			myfile << i << "  " << k.getValue(i) << " " << k.getCost(i) << endl;
 		}
 	}
 	myfile << endl;
@@ -246,7 +329,6 @@ void knapsackOutput(knapsack & k)
 void knapsackRun()
 // Runs an algorithm to solve the knapsack problem
 {
-	ifstream fin;
 	string fileName;
 
 	// Read the name of the graph from the keyboard or
@@ -278,28 +360,39 @@ void knapsackRun()
 	for (int i = 0; i < s.size(); i++)
 	{
 		fileName = s[i];
-		fin.open(fileName.c_str());
-		if (!fin)
-		{
-			cerr << "Cannot open " << fileName << endl;
-			exit(1);
-		}
 
 		try
 		{
-			knapsack k(fin);
+			// Parsed inputs are cached beside the input file as fileName.bin (see loader.h)
+			knapsackData data;
+			loadKnapsack(fileName, data, true);
+			knapsack k(data);
+			STATS_RESET();
 
 			//exhaustiveKnapsack(k, 600);
 			//greedyKnapsack(k);
 			//branchAndBound(k, 600);
+			//branchAndBound(k, 600, hybrid);
+			//branchAndBound(k, 600, depthFirst, 1 << 22, enumerativeBound);
+			//branchAndBound(k, 600, depthFirst, 1 << 22, martelloTothBound, defaultBoundDepth, (size_t)1 << 28);
+			//exactKnapsack(k, 600);
+			//coreKnapsack(k);
+			//cout << "Gap " << fptasKnapsack(k, 0.01) << endl;
+			//parallelBranchAndBound(k, 600, thread::hardware_concurrency());
 			steepestDescent(k);
 
-			// For steepestDescent, use bestNeighbor(knapsack &k, Neighbor &currentNeighbor) 
-			//or bestNeighborTabu(knapsack &k, Neighbor &currentNeighbor, vector<int> &tabuIndicies)
+			//tabuSearch(k, 10);
+			//multiStartSearch(k, 256, thread::hardware_concurrency(), 1);
+			//simulatedAnnealing(k, 10, 1);
+			//cout << "Fixed " << reduceAndSolve(k, [](knapsack &r) { branchAndBound(r, 600); }) << " items" << endl;
 
+			// steepestDescent and tabuSearch score their moves with a Neighborhood (see neighborhood.h)
 
-			// Write solution to output file
+
+			// Write solution to output file, and the search counters beside it when
+			// SEARCH_STATS is defined (see searchstats.h)
 			knapsackOutput(k);
+			STATS_WRITE("knapsack/output/knapsack" + to_string(k.getNumObjects()) + ".stats.json");
 
 			cout << endl << "Best solution" << endl;
 			k.printSolution();
@@ -313,7 +406,9 @@ void knapsackRun()
 		{
 			cout << ex.what() << endl; exit(1);
 		}
-
-		fin.close();
+		catch (baseException &ex)
+		{
+			cerr << ex.what() << endl; exit(1);
+		}
 	}
 }
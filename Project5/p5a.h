@@ -1,18 +1,43 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <limits.h>
 #include <list>
 #include <fstream>
 #include <queue>
 #include <stack>
+#include <thread>
 #include <vector>
 #include <time.h>
 
 #include "d_except.h"
 #include "d_matrix.h"
+#include "annealing.h"
+#include "anytime.h"
+#include "bbnode.h"
+#include "coreknapsack.h"
+#include "fptas.h"
 #include "knapsack.h"
+#include "knapsackdp.h"
+#include "loader.h"
+#include "multistart.h"
 #include "neighbor.h"
+#include "neighborhood.h"
+#include "parallelbb.h"
+#include "reduction.h"
+#include "searchstats.h"
 
+Solution toSolution(const knapsack &k, const vector<int> &items);
+void greedyKnapsack(knapsack &k);
+void steepestDescent(knapsack &k);
+void branchAndBound(knapsack &k, int time, bbStrategy strategy = depthFirst, int maxNodes = 1 << 22,
+	boundType bound = martelloTothBound, int boundDepth = defaultBoundDepth, size_t dominanceBytes = 0);
+void branchAndBound(knapsack &k, searchControl &control, bbStrategy strategy = depthFirst, int maxNodes = 1 << 22,
+	boundType bound = martelloTothBound, int boundDepth = defaultBoundDepth, size_t dominanceBytes = 0,
+	const knapsackCallback &onImprove = knapsackCallback(), dominanceStats *stats = NULL);
+void tabuSearch(knapsack &k, int time, int maxIterations = INT_MAX);
+void tabuSearch(knapsack &k, searchControl &control, int maxIterations = INT_MAX,
+	const knapsackCallback &onImprove = knapsackCallback());
 void knapsackRun();
 
@@ -4,40 +4,20 @@
 
 #include "p5b.h"
 
-void initializeGraphs(Graph &g1, Graph &g2, ifstream &fin)
-// Initialize g1 and g2 using data from fin.
+csrGraph toCsrGraph(Graph &g)
+// Return a compressed copy of the edges of g.
 {
-	int n, e;
-	int j, k;
+	vector<int> endpoints;
+	endpoints.reserve(2 * num_edges(g));
 
-	fin >> n >> e;
-	Graph::vertex_descriptor v1;
-	Graph::vertex_descriptor v2;
-
-	// Add nodes.
-	for (int i = 0; i < n; i++)
-	{
-		v1 = add_vertex(g1);
-		v2 = add_vertex(g2);
-	}
-
-	for (int i = 0; i < e; i++)
+	pair<Graph::edge_iterator, Graph::edge_iterator> eItrRange = edges(g);
+	for (Graph::edge_iterator eItr = eItrRange.first; eItr != eItrRange.second; ++eItr)
 	{
-		fin >> j >> k;
-		add_edge(j, k, g1);  // Assumes vertex list is type vecS
-		add_edge(j, k, g2);
+		endpoints.push_back((int)source(*eItr, g));
+		endpoints.push_back((int)target(*eItr, g));
 	}
-}
 
-void cloneGraphColors(Graph &g, Graph &c)
-// Takes two graphs with the same nodes and sets the colors of c to the colors of g.
-{
-	pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
-
-	for (Graph::vertex_iterator vItr = vItrRange.first; vItr != vItrRange.second; ++vItr)
-	{
-		c[*vItr].color = g[*vItr].color;
-	}
+	return csrGraph((int)num_vertices(g), endpoints);
 }
 
 void setNodeWeights(Graph &g, int w)
@@ -51,272 +31,262 @@ void setNodeWeights(Graph &g, int w)
 	}
 }
 
-void setNodeColors(Graph &g, int c)
-// Set all node colors to c (integer representation of a color).
+void setColors(Graph &g, const coloring &colors)
+// Set the colors of g to colors.
 {
-	pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
-
-	for (Graph::vertex_iterator vItr = vItrRange.first; vItr != vItrRange.second; ++vItr)
-	{
-		g[*vItr].color = c;
-	}
+	for (int v = 0; v < (int)colors.size(); v++)
+		g[v].color = colors[v];
 }
 
-void setNodeMarks(Graph &g, bool b)
-// Set all node weights to w.
+void checkNumColors(int numColors)
+// Throw if numColors colors cannot be held in a coloring.
 {
-	pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
-
-	for (Graph::vertex_iterator vItr = vItrRange.first; vItr != vItrRange.second; ++vItr)
-	{
-		g[*vItr].marked = b;
-	}
+	if (numColors < 1 || numColors > maxColors)
+		throw rangeError("Bad number of colors in graph coloring");
 }
 
-int checkConflicts(Graph &g)
-// Return the number of nodes in conflict in a graph.
-// For each edge with two nodes of the same color, there is one node in conflict.
+int checkConflicts(const csrGraph &g, const coloring &colors)
+// Return the number of edges whose two nodes have the same color, visiting each edge from its
+// lower numbered end.
 {
 	int numConflicts = 0;
-	setNodeMarks(g, false);
-	pair<Graph::edge_iterator, Graph::edge_iterator> eItrRange = edges(g);
-	for (Graph::edge_iterator eItr = eItrRange.first; eItr != eItrRange.second; ++eItr)
+
+	for (int v = 0; v < g.getNumNodes(); v++)
 	{
-		Graph::vertex_descriptor t = target(*eItr, g);
-		Graph::vertex_descriptor s = source(*eItr, g);
-		if (g[t].color == g[s].color)
-		{
-			numConflicts++;
-		}
+		int color = colors[v];
+		for (const int *u = g.adjacentBegin(v); u != g.adjacentEnd(v); ++u)
+			if (*u >= v && colors[*u] == color)
+				numConflicts++;
 	}
+
 	return numConflicts;
 }
 
-int nodeConflicts(Graph &g, Graph::vertex_iterator &v, int color)
+int nodeConflicts(const csrGraph &g, const coloring &colors, int v, int color)
+// Return the number of neighbors of v that have the given color.
 {
 	int numConflicts = 0;
 
-	pair<Graph::adjacency_iterator, Graph::adjacency_iterator> vItrRange = adjacent_vertices(*v, g);
-	for (Graph::adjacency_iterator vItr = vItrRange.first; vItr != vItrRange.second; ++vItr)
-	{
-		if (g[*vItr].color == color)
+	for (const int *u = g.adjacentBegin(v); u != g.adjacentEnd(v); ++u)
+		if (colors[*u] == color)
 			numConflicts++;
-	}
+
 	return numConflicts;
 }
 
-bool increment(Graph &g, Graph::vertex_iterator vItr, int numColors, Graph::vertex_iterator vEnd)
+bool increment(coloring &colors, int numColors)
 // Used to cycle through all the different permutations of graph coloring, one at a time.
-// With all vertices stored in a linear array, and all colors represented by integers,
-// the graph functions in a remarkably similar way to a counter.
+// With all colors represented by integers, the coloring works like a counter whose
+// lowest digit is node 0.
 // Returns true if last value of counter has been reached, false otherwise.
 {
-	g[*vItr].color++;
-	if (g[*vItr].color == numColors)
+	for (int v = 0; v < (int)colors.size(); v++)
 	{
-		g[*vItr].color = 0;
-		++vItr;
-		if (vItr == vEnd)
-			return true;
-		else
-			increment(g, vItr, numColors, vEnd);
+		// Counted in int, since with maxColors colors the last color is the largest unsigned short
+		int color = colors[v] + 1;
+		if (color < numColors)
+		{
+			colors[v] = (unsigned short)color;
+			return false;
+		}
+
+		colors[v] = 0;
 	}
-	return false;
+
+	return true;
+}
+
+bool increment(conflictTable &t)
+// Step the coloring of t like increment(coloring &, int), recoloring through the table so that
+// the conflict count stays current.  A step recolors fewer than two nodes on average.
+{
+	int n = (int)t.getColors().size();
+
+	for (int v = 0; v < n; v++)
+	{
+		int color = t.getColor(v) + 1;
+		if (color < t.getNumColors())
+		{
+			t.recolor(v, color);
+			return false;
+		}
+
+		t.recolor(v, 0);
+	}
+
+	return true;
 }
 
 int exhaustiveColoring(Graph &g, int numColors, int t)
-// Increment through all permutations of the graph using the increment() function.
-// Check number of conflicts, and store lowest number that has been checked.
-// Return number of conflicts when done, or when time t has passed.
+// Exhaustive coloring for at most t seconds.
 {
-	clock_t startTime = clock();
+	searchControl control((double)t);
+	return exhaustiveColoring(g, numColors, control);
+}
 
-	setNodeColors(g, 0);
-	int numConflicts = checkConflicts(g);
-	int tempNumConflicts = numConflicts;
-	bool finished = false;
-	Graph minGraph(num_vertices(g));
-	cloneGraphColors(g, minGraph);
+int exhaustiveColoring(Graph &g, int numColors, searchControl &control, const coloringCallback &onImprove)
+// Exhaustive coloring of g, run on a compressed copy of its edges.
+{
+	csrGraph c = toCsrGraph(g);
+	coloring colors;
+	int numConflicts = exhaustiveColoring(c, colors, numColors, control, onImprove);
+	setColors(g, colors);
 
-	pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
+	return numConflicts;
+}
 
-	for (;;)
-	{
-		finished = increment(g, vItrRange.first, numColors, vItrRange.second);
+int exhaustiveColoring(const csrGraph &g, coloring &colors, int numColors, searchControl &control, const coloringCallback &onImprove)
+// Increment through all permutations of the graph using the increment() function.
+// Check number of conflicts, and store lowest number that has been checked.
+// Return number of conflicts when done, or when control stops the search.
+// onImprove, if set, is called with each coloring that has fewer conflicts than any before.
+{
+	checkNumColors(numColors);
 
-		if (finished)
-			break;
+	conflictTable t(g, numColors);
+	int numConflicts = t.getNumConflicts();
+	coloring minColors = t.getColors();
 
-		tempNumConflicts = checkConflicts(g);
+	while (numConflicts > 0 && !increment(t))
+	{
+		int tempNumConflicts = t.getNumConflicts();
 
 		if (tempNumConflicts < numConflicts) {
 			numConflicts = tempNumConflicts;
-			cloneGraphColors(g, minGraph);
-		}
+			minColors = t.getColors();
 
-		if (numConflicts == 0)
-			break;
+			if (onImprove)
+				onImprove(numConflicts, minColors);
+		}
 
-		// Check if time is expired and return
-		if ((clock() - startTime) / CLOCKS_PER_SEC >= t)
+		// Check if time is expired or the search is cancelled and return
+		if (control.stopped())
 			break;
-
-		//cout << "Conflicts: " << tempNumConflicts << endl;
 	}
 
-	cloneGraphColors(minGraph, g);
+	colors = minColors;
 
 	return numConflicts;
 }
 
-vector<Graph::vertex_descriptor> getVertices(Graph &g)
-// Get the number of vertices in a graph.
+int greedyColor(const csrGraph &g, coloring &colors, int numColors)
+// Color the nodes in order, giving each the color shared by the fewest of its neighbors
+// colored so far.  Returns the number of conflicts.
 {
-	vector<Graph::vertex_descriptor> nodes;
+	checkNumColors(numColors);
 
-	pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
+	colors.assign(g.getNumNodes(), 0);
+	vector<int> count(numColors);
 
-	for (Graph::vertex_iterator vItr = vItrRange.first; vItr != vItrRange.second; ++vItr)
+	for (int v = 0; v < g.getNumNodes(); v++)
 	{
-		g[*vItr].color = -1;
-		nodes.push_back(*vItr);
+		fill(count.begin(), count.end(), 0);
+		for (const int *u = g.adjacentBegin(v); u != g.adjacentEnd(v); ++u)
+			if (*u < v)
+				count[colors[*u]]++;
+
+		colors[v] = (unsigned short)(min_element(count.begin(), count.end()) - count.begin());
 	}
 
-	return nodes;
+	return checkConflicts(g, colors);
 }
 
-int getConflict(Graph &g)
-// Same implementation as getDegree but searching for conflicts
+int twoOpt(conflictTable &t, int v)
+// Give node v the color shared by the fewest of its neighbors, keeping its color on ties.
+// Each color is scored from the conflict table.  Returns the number of conflicts removed.
 {
-	int conflict = 0;
+	int bestColor = t.getColor(v);
+	int bestDelta = 0;
 
-	Graph::vertex_descriptor targetNode;
-	Graph::vertex_descriptor sourceNode;
-	pair<Graph::edge_iterator, Graph::edge_iterator> eItrRange = edges(g);
-
-	for (Graph::edge_iterator eItr = eItrRange.first; eItr != eItrRange.second; ++eItr)
+	for (int color = 0; color < t.getNumColors(); color++)
 	{
-		targetNode = target(*eItr, g);
-		sourceNode = source(*eItr, g);
-
-		if (g[targetNode].color == g[sourceNode].color)
+		int tempDelta = t.delta(v, color);
+		if (tempDelta < bestDelta)
 		{
-			conflict++;
+			bestDelta = tempDelta;
+			bestColor = color;
 		}
 	}
 
-	return conflict;
+	t.recolor(v, bestColor);
+
+	return -bestDelta;
 }
 
-void setColor(int color, Graph::vertex_descriptor &v, Graph &g)
-// Set a color to graph.
+int steepestDescent(Graph &g, int numColors, int time)
 {
-	g[v].color = color;
+	searchControl control((double)time);
+	return steepestDescent(g, numColors, control);
 }
 
-int getBestColor(int numColors, Graph::vertex_descriptor &v, Graph &g)
-// Return best color pair from a set of colors.
+int steepestDescent(Graph &g, int numColors, searchControl &control, const coloringCallback &onImprove)
+// Local search on g, run on a compressed copy of its edges.
 {
-	int color = 1;
-
-	Graph::vertex_descriptor targetNode;
-	Graph::vertex_descriptor sourceNode;
-	pair<Graph::edge_iterator, Graph::edge_iterator> eItrRange = edges(g);
-
-	for (Graph::edge_iterator eItr = eItrRange.first; eItr != eItrRange.second; ++eItr)
-	{
-		targetNode = target(*eItr, g);
-		sourceNode = source(*eItr, g);
-
-		if (targetNode == v)
-		{
-			if (g[sourceNode].color == g[v].color)
-			{
-				color++;
-				if (color == numColors)
-				{
-					return 0;
-				}
-			}
-		}
+	csrGraph c = toCsrGraph(g);
+	coloring colors;
+	int numConflicts = steepestDescent(c, colors, numColors, control, onImprove);
+	setColors(g, colors);
 
-		else
-		{
-			if (sourceNode == v)
-			{
-				if (g[targetNode].color == g[v].color)
-				{
-					color++;
-					if (color == numColors)
-					{
-						return 0;
-					}
-				}
-			}
-		}
-	}
-
-	return color;
+	return numConflicts;
 }
 
-int greedyColor(Graph &g, int numColors)
+int steepestDescent(const csrGraph &g, coloring &colors, int numColors, searchControl &control, const coloringCallback &onImprove)
+// Local search from the DSatur coloring; see below.
 {
-	//cout << endl << "Performing Greedy";
-	int color = -1;
-	vector<Graph::vertex_descriptor> vertexVector = getVertices(g);
-
-	for (int i = 0; i < vertexVector.size(); i++)
-	{
-		color = getBestColor(numColors, vertexVector[i], g);
-		setColor(color, vertexVector[i], g);
-	}
-
-	return getConflict(g);
+	tabuColResult result;
+	return steepestDescent(g, colors, numColors, control, result, onImprove);
 }
 
-void twoOpt(Graph &g, Graph::vertex_iterator &v, int numColors)
-// Search for a better color for node
+int steepestDescent(const csrGraph &g, coloring &colors, int numColors, searchControl &control, tabuColResult &result,
+	const coloringCallback &onImprove)
+// Start from the DSatur coloring and recolor conflicting nodes one at a time with twoOpt,
+// sweeping them until a sweep removes no conflict.  Then run TabuCol (see tabucol.h) until
+// there are no conflicts or control stops the search, and describe that run in result.
 {
-	int initialColor = g[*v].color;
-	int numConflicts = nodeConflicts(g, v, initialColor);
+	int numConflicts = dsaturColor(g, colors, numColors);
+	if (onImprove)
+		onImprove(numConflicts, colors);
 
-	pair<Graph::adjacency_iterator, Graph::adjacency_iterator> vItrRange = adjacent_vertices(*v, g);
+	conflictTable t(g, numColors);
+	t.reset(colors);
 
-	for (Graph::adjacency_iterator vItr = vItrRange.first; vItr != vItrRange.second && numConflicts > 0; ++vItr)
+	bool improved = true;
+	vector<int> sweep;
+	while (improved && t.getNumConflicts() > 0 && !control.stopped())
 	{
-		int color = g[*vItr].color;
+		improved = false;
 
-		int tempConflicts = nodeConflicts(g, v, color);
-		if (tempConflicts < numConflicts)
-		{
-			numConflicts = tempConflicts;
-			g[*v].color = color;
-		}
-	}
-}
+		// The set of conflicting nodes changes as they are recolored, so sweep a copy
+		sweep.clear();
+		for (int i = 0; i < t.getNumConflicting(); i++)
+			sweep.push_back(t.getConflicting(i));
 
-int steepestDescent(Graph &g, int numColors, int time)
-{
-	clock_t startTime = clock();
-	greedyColor(g, numColors);
+		for (int i = 0; i < (int)sweep.size() && t.getNumConflicts() > 0; i++)
+			if (twoOpt(t, sweep[i]) > 0)
+				improved = true;
+
+		if (improved && onImprove)
+			onImprove(t.getNumConflicts(), t.getColors());
+	}
 
-	/*pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
-	for (Graph::vertex_iterator vItr = vItrRange.first; vItr != vItrRange.second && ((clock() - startTime) / CLOCKS_PER_SEC < time); ++vItr)
-		neighborhood(g, vItr, numColors);*/
+	colors = t.getColors();
 
-	return checkConflicts(g);
+	return tabuColoring(g, colors, numColors, control, 1, result, onImprove);
 }
 
-int randomColor(Graph &g, int numColors)
+int randomColor(const csrGraph &g, coloring &colors, int numColors)
+// Give every node a random color and return the number of conflicts.
 {
-	pair<Graph::vertex_iterator, Graph::vertex_iterator> vItrRange = vertices(g);
-	for (Graph::vertex_iterator vItr = vItrRange.first; vItr != vItrRange.second; ++vItr)
-		g[*vItr].color = rand() % numColors;
+	checkNumColors(numColors);
+
+	colors.resize(g.getNumNodes());
+	for (int v = 0; v < g.getNumNodes(); v++)
+		colors[v] = (unsigned short)(rand() % numColors);
 
-	return checkConflicts(g);
+	return checkConflicts(g, colors);
 }
 
-void printSolution(Graph &g, int numConflicts, string filename)
+void printSolution(const coloring &colors, int numConflicts, string filename)
 // Print the solution found.
 {
 	string filepath = "color/output/" + filename + ".output";
@@ -324,9 +294,9 @@ void printSolution(Graph &g, int numConflicts, string filename)
 	myfile.open((filepath).c_str());
 
 	myfile << "Total Conflicts: " << numConflicts << endl;
-	for (int counter = 0; counter < num_vertices(g); ++counter)
+	for (int counter = 0; counter < (int)colors.size(); ++counter)
 	{
-		myfile << counter << ": " << g[counter].color << endl;
+		myfile << counter << ": " << colors[counter] << endl;
 	}
 	myfile.close();
 }
@@ -335,8 +305,6 @@ void graphColoring()
 // Finds a graph coloring solution
 // Takes in an input file for graph, results in output file
 {
-	char x;
-	ifstream fin;
 	string fileName;
 
 	// Read the name of the graph from the keyboard or
@@ -348,36 +316,38 @@ void graphColoring()
 	cin >> fileName;
 	string filePath = "color/input/" + fileName + ".input";
 
-	fin.open((filePath).c_str());
-	if (!fin)
-	{
-		cerr << "Cannot open " << filePath << endl;
-		exit(1);
-	}
-
 	try
 	{
 		cout << "Reading graph" << endl;
-		Graph g1;
-		Graph g2;
 		int numColors;
 		int numConflicts = -1;
-		fin >> numColors;
-		initializeGraphs(g1, g2, fin);
-	
-		greedyColor(g2, numColors);
+		colorData data;
+		loadColoring(filePath, data, true);
+		numColors = data.numColors;
+
+		// Every search reads the same compressed graph and keeps its own colors (see csrgraph.h)
+		csrGraph g(data);
+		coloring colors1;
+		coloring colors2;
 
-		cout << "Num nodes: " << num_vertices(g1) << endl;
-		cout << "Num edges: " << num_edges(g1) << endl;
+		cout << "Num nodes: " << g.getNumNodes() << endl;
+		cout << "Num edges: " << g.getNumEdges() << endl;
 		cout << endl;
 
-		// Part 1: Steepest Descent
-		numConflicts = steepestDescent(g1, numColors, 300);
-		printSolution(g1, numConflicts, fileName + "part1");
+		// Part 1: Steepest Descent, as a portfolio of TabuCol searches on every core (see portfolio.h)
+		searchControl control(300.0);
+		tabuColResult result;
+		//numConflicts = steepestDescent(g, colors1, numColors, control, result);
+		numConflicts = portfolioColoring(g, colors1, numColors, control, max(1, (int)thread::hardware_concurrency()), 1, result);
+		printSolution(colors1, numConflicts, fileName + "part1");
+
+		cout << "Conflicts: " << numConflicts << endl;
+		cout << "TabuCol iterations: " << result.iterations << " in " << result.seconds << " s ("
+			<< result.iterationsPerSecond() << " per second)" << endl;
 
 		// Part 2: Other Algorithm (Random)
-		numConflicts = randomColor(g2, numColors);
-		printSolution(g2, numConflicts, fileName + "part2");
+		numConflicts = randomColor(g, colors2, numColors);
+		printSolution(colors2, numConflicts, fileName + "part2");
 	}
 	catch (indexRangeError &ex)
 	{
@@ -387,6 +357,10 @@ void graphColoring()
 	{
 		cout << ex.what() << endl; exit(1);
 	}
+	catch (baseException &ex)
+	{
+		cerr << ex.what() << endl; exit(1);
+	}
 
 }
 
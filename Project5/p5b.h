@@ -6,6 +6,15 @@
 #include <fstream>
 #include <time.h>
 #include <stdlib.h>
+#include <thread>
+
+#include "anytime.h"
+#include "conflicttable.h"
+#include "csrgraph.h"
+#include "dsatur.h"
+#include "loader.h"
+#include "portfolio.h"
+#include "tabucol.h"
 
 #include <boost/graph/adjacency_list.hpp>
 
@@ -39,14 +48,26 @@ struct EdgeProperties
 	bool marked;
 };
 
-void initializeGraphs(Graph &g, Graph &g2, ifstream &fin);
-//void initializeGraphs(Graph &g, Graph &g2, ifstream &fin);
-void cloneGraphColors(Graph &g, Graph &c);
-void setNodeColors(Graph &g, int c);
+void setColors(Graph &g, const coloring &colors);
+
 void setNodeWeights(Graph &g, int w);
-void setNodeMarks(Graph &g, bool b);
-int checkConflicts(Graph &g);
-bool increment(Graph &g, Graph::vertex_iterator vItr, int numColors, Graph::vertex_iterator vEnd);
+int checkConflicts(const csrGraph &g, const coloring &colors);
+int nodeConflicts(const csrGraph &g, const coloring &colors, int v, int color);
+bool increment(coloring &colors, int numColors);
+bool increment(conflictTable &t);
+int greedyColor(const csrGraph &g, coloring &colors, int numColors);
+int randomColor(const csrGraph &g, coloring &colors, int numColors);
 int exhaustiveColoring(Graph &g, int numColors, int t);
-void printSolution(Graph &g, int numConflicts, string filename);
+int exhaustiveColoring(Graph &g, int numColors, searchControl &control,
+	const coloringCallback &onImprove = coloringCallback());
+int exhaustiveColoring(const csrGraph &g, coloring &colors, int numColors, searchControl &control,
+	const coloringCallback &onImprove = coloringCallback());
+int steepestDescent(Graph &g, int numColors, int time);
+int steepestDescent(Graph &g, int numColors, searchControl &control,
+	const coloringCallback &onImprove = coloringCallback());
+int steepestDescent(const csrGraph &g, coloring &colors, int numColors, searchControl &control,
+	const coloringCallback &onImprove = coloringCallback());
+int steepestDescent(const csrGraph &g, coloring &colors, int numColors, searchControl &control, tabuColResult &result,
+	const coloringCallback &onImprove = coloringCallback());
+void printSolution(const coloring &colors, int numConflicts, string filename);
 void graphColoring();
@@ -0,0 +1,277 @@
+// File: parallelbb.cpp
+// Work-stealing branch and bound.  Each worker runs the same depth first search as
+// branchAndBound on its own deque of bbNodes and its own decisionTrail.  A worker that runs
+// out of nodes asks another worker for work, and that worker hands over the oldest (shallowest)
+// open node in its deque along with the items taken on the way to it.  Only the owner ever
+// touches a deque or trail, so the hot loop takes no locks; the incumbent value is shared
+// through an atomic so that every worker prunes against the best solution found so far.
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "bbnode.h"
+#include "parallelbb.h"
+#include "searchstats.h"
+
+using namespace std;
+
+namespace
+{
+	const int noRequest = -1;
+
+	enum responseType { waiting, gotWork, noWork };
+
+	struct bbWorker
+	{
+		deque<bbNode> nodes;
+		decisionTrail trail;
+		vector<int> scratch;
+
+		// Id of the worker asking this one for work, or noRequest
+		atomic<int> request;
+
+		// Answer to this worker's own request, and the node handed over with it
+		atomic<int> response;
+		bbNode gift;
+		vector<int> giftItems;
+	};
+
+	struct bbShared
+	{
+		const knapsack *k;
+		vector<int> items;
+		vector<bbWorker> workers;
+
+		atomic<int> incumbentValue;
+		mutex incumbentLock;
+		vector<int> incumbentItems;
+
+		// Number of workers holding open nodes, including nodes in transit to a thief
+		atomic<int> numBusy;
+		atomic<bool> stop;
+		searchControl control;	// copied by each worker
+		boundType bound;		// used above boundDepth, with the Dantzig bound below
+		int boundDepth;
+		size_t dominanceBytes;	// size of each worker's dominance table, or 0 for none
+		dominanceStats dominanceTotals;	// of the workers that have finished, under incumbentLock
+		knapsackCallback onImprove;
+
+		bbShared(int numThreads, const searchControl &control) : workers(numThreads), control(control) {}
+	};
+
+	void updateIncumbent(bbShared &shared, bbWorker &worker, const bbNode &node)
+	// Offer node as the new incumbent.
+	{
+		if (node.value <= shared.incumbentValue.load(memory_order_relaxed))
+			return;
+
+		lock_guard<mutex> lock(shared.incumbentLock);
+		if (node.value > shared.incumbentValue.load(memory_order_relaxed))
+		{
+			worker.trail.getItems(node.trail, shared.incumbentItems);
+			shared.incumbentValue.store(node.value, memory_order_relaxed);
+			STAT_INCUMBENT(node.value);
+
+			if (shared.onImprove)
+			{
+				Solution items(shared.k->getNumObjects());
+				for (int i = 0; i < (int)shared.incumbentItems.size(); i++)
+					items.set(shared.incumbentItems[i]);
+				shared.onImprove(node.value, items);
+			}
+		}
+	}
+
+	void answerRequest(bbShared &shared, bbWorker &worker)
+	// Hand the oldest open node to a waiting thief, keeping at least one node for ourselves.
+	{
+		int thief = worker.request.load(memory_order_acquire);
+		if (thief == noRequest)
+			return;
+
+		bbWorker &other = shared.workers[thief];
+
+		if (worker.nodes.size() >= 2)
+		{
+			bbNode node = worker.nodes.front();
+			worker.nodes.pop_front();
+
+			other.gift = node;
+			worker.trail.getItems(node.trail, other.giftItems);
+			worker.trail.release(node.trail);
+
+			shared.numBusy.fetch_add(1);
+			other.response.store(gotWork, memory_order_release);
+		}
+		else
+			other.response.store(noWork, memory_order_release);
+
+		worker.request.store(noRequest, memory_order_release);
+	}
+
+	bool steal(bbShared &shared, int self, int victim)
+	// Ask victim for work, answering "no" to anyone who asks us meanwhile.
+	// Returns true if a node was received and pushed onto our deque.
+	{
+		bbWorker &worker = shared.workers[self];
+		int expected = noRequest;
+
+		worker.response.store(waiting, memory_order_relaxed);
+		if (!shared.workers[victim].request.compare_exchange_strong(expected, self, memory_order_acq_rel))
+			return false;
+
+		// Give up if the search has ended, since the victim may already have left
+		while (worker.response.load(memory_order_acquire) == waiting)
+		{
+			if (shared.stop.load(memory_order_relaxed) || shared.numBusy.load() == 0)
+				return false;
+
+			answerRequest(shared, worker);
+			this_thread::yield();
+		}
+
+		if (worker.response.load(memory_order_acquire) != gotWork)
+			return false;
+
+		// Rebuild the gift's decisions in our own trail
+		bbNode node = worker.gift;
+		node.trail = decisionTrail::none;
+		for (int i = 0; i < (int)worker.giftItems.size(); i++)
+		{
+			int entry = worker.trail.take(node.trail, worker.giftItems[i]);
+			worker.trail.release(node.trail);
+			node.trail = entry;
+		}
+
+		worker.nodes.push_back(node);
+		return true;
+	}
+
+	void parallelWorker(bbShared &shared, int self)
+	// Worker loop: depth first search of our own deque, stealing when it runs dry.
+	{
+		bbWorker &worker = shared.workers[self];
+		int numWorkers = (int)shared.workers.size();
+		int victim = self;
+		searchControl control = shared.control;
+		dominanceTable dominance(shared.dominanceBytes);
+
+		while (!shared.stop.load(memory_order_relaxed))
+		{
+			if (worker.nodes.empty())
+			{
+				answerRequest(shared, worker);
+
+				if (shared.numBusy.load() == 0)
+					break;
+
+				victim = (victim + 1) % numWorkers;
+				if (victim == self || !steal(shared, self, victim))
+					this_thread::yield();
+
+				continue;
+			}
+
+			answerRequest(shared, worker);
+
+			bbNode current = worker.nodes.back();
+			worker.nodes.pop_back();
+
+			updateIncumbent(shared, worker, current);
+
+			int incumbentValue = shared.incumbentValue.load(memory_order_relaxed);
+			if (!isFathomed(*shared.k, current, incumbentValue) && !(shared.dominanceBytes > 0 && dominance.dominated(current)))
+			{
+				STAT_ADD(nodesExpanded, 1);
+				STAT_MAX(maxSearchDepth, current.depth);
+				STAT_MAX(maxOpenNodes, worker.nodes.size() + 1);
+
+				bbNode children[2];
+				boundType type = current.depth < shared.boundDepth ? shared.bound : dantzigBound;
+				int numChildren = branch(*shared.k, shared.items, worker.trail, current, incumbentValue, children, type);
+
+				for (int i = 0; i < numChildren; i++)
+					worker.nodes.push_back(children[i]);
+			}
+
+			worker.trail.release(current.trail);
+
+			if (worker.nodes.empty())
+				shared.numBusy.fetch_sub(1);
+
+			if (control.stopped())
+				shared.stop.store(true, memory_order_relaxed);
+		}
+
+		// Answer any thief still waiting on us before leaving
+		worker.nodes.clear();
+		answerRequest(shared, worker);
+
+		lock_guard<mutex> lock(shared.incumbentLock);
+		shared.dominanceTotals.probes += dominance.getStats().probes;
+		shared.dominanceTotals.hits += dominance.getStats().hits;
+		shared.dominanceTotals.prunes += dominance.getStats().prunes;
+	}
+}
+
+void parallelBranchAndBound(knapsack &k, int time, int numThreads)
+// Branch and bound on numThreads threads, stopping after time seconds (wall clock).
+{
+	searchControl control((double)time);
+	parallelBranchAndBound(k, control, numThreads);
+}
+
+void parallelBranchAndBound(knapsack &k, const searchControl &control, int numThreads, boundType bound, int boundDepth,
+	size_t dominanceBytes, const knapsackCallback &onImprove, dominanceStats *stats)
+// Branch and bound on numThreads threads, until the search space is exhausted or control stops it.
+// Returns the same optimal value as branchAndBound when the search completes.
+// Children of nodes shallower than boundDepth are bounded with bound, and the rest with the
+// Dantzig bound, as in branchAndBound.
+// With dominanceBytes > 0, each worker prunes dominated nodes with a dominanceTable of that size,
+// and stats, if set, gets the counts of all the tables together.
+// onImprove, if set, is called with each new incumbent, from whichever thread found it.
+{
+	if (numThreads < 1)
+		numThreads = 1;
+
+	bbShared shared(numThreads, control);
+	shared.onImprove = onImprove;
+	shared.bound = bound;
+	shared.boundDepth = boundDepth;
+	shared.dominanceBytes = dominanceBytes;
+	shared.dominanceTotals.probes = 0;
+	shared.dominanceTotals.hits = 0;
+	shared.dominanceTotals.prunes = 0;
+	shared.k = &k;
+	shared.items = k.sort();
+	shared.incumbentValue = k.getValue();
+	shared.incumbentItems = k.getIndicies();
+	shared.numBusy = 1;
+	shared.stop = false;
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		shared.workers[i].request = noRequest;
+		shared.workers[i].response = waiting;
+	}
+
+	bbNode root = { 0, 0, 0, k.bound(0, 0, 0), decisionTrail::none };
+	shared.workers[0].nodes.push_back(root);
+
+	vector<thread> threads;
+	for (int i = 1; i < numThreads; i++)
+		threads.push_back(thread(parallelWorker, ref(shared), i));
+
+	parallelWorker(shared, 0);
+
+	for (int i = 0; i < (int)threads.size(); i++)
+		threads[i].join();
+
+	if (stats != NULL)
+		*stats = shared.dominanceTotals;
+
+	k.setItems(shared.incumbentItems);
+}
@@ -0,0 +1,11 @@
+// Parallel branch and bound for the knapsack problem
+#pragma once
+
+#include "anytime.h"
+#include "bbnode.h"
+#include "knapsack.h"
+
+void parallelBranchAndBound(knapsack &k, int time, int numThreads);
+void parallelBranchAndBound(knapsack &k, const searchControl &control, int numThreads,
+	boundType bound = martelloTothBound, int boundDepth = defaultBoundDepth, size_t dominanceBytes = 0,
+	const knapsackCallback &onImprove = knapsackCallback(), dominanceStats *stats = NULL);
@@ -0,0 +1,181 @@
+// File: portfolio.cpp
+// Runs independent TabuCol searches on the same graph, one per thread.  Worker w starts from the
+// coloring and uses the tenure of strategies[w % numStrategies].  Its random start and its
+// TabuCol run draw from two randomNumber streams of their own, seeded from the run's seed and w,
+// so the search does not replay the numbers that made the start.  The graph is shared and only
+// read; each worker has its own colors and conflict table.  A worker publishes each coloring
+// better than the best so far to a shared slot, and the first to reach zero conflicts cancels the
+// rest.
+//
+// Each worker's search depends only on the seed and its number, so a run is reproduced by
+// running with the same seed and number of threads up to the point where the clock or another
+// worker stops it.  Ties for the best coloring go to the lowest numbered worker.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits.h>
+#include <mutex>
+#include <thread>
+
+#include "anytime.h"
+#include "d_random.h"
+#include "dsatur.h"
+#include "portfolio.h"
+
+using namespace std;
+
+namespace
+{
+	enum startType { dsaturStart, randomStart };
+
+	struct portfolioStrategy
+	{
+		startType start;
+		int tenureRange;
+		double tenureFactor;
+	};
+
+	const portfolioStrategy strategies[] =
+	{
+		{ dsaturStart, 10, 0.6 },
+		{ randomStart, 10, 0.6 },
+		{ dsaturStart, 5, 1.0 },
+		{ randomStart, 20, 0.3 },
+	};
+
+	const int numStrategies = sizeof(strategies) / sizeof(strategies[0]);
+
+	struct portfolioShared
+	{
+		const csrGraph *g;
+		int numColors;
+		long seed;
+		chrono::steady_clock::time_point deadline;
+		cancellationToken solved;	// set when a worker reaches zero conflicts, or to stop every worker
+		coloringCallback onImprove;
+
+		mutex bestLock;
+		int bestConflicts;
+		int bestWorker;
+		coloring bestColors;
+
+		atomic<long long> iterations;
+		atomic<int> numRunning;
+	};
+
+	void publish(portfolioShared &shared, int worker, int numConflicts, const coloring &colors)
+	// Offer a worker's new best coloring to the shared slot.
+	{
+		lock_guard<mutex> lock(shared.bestLock);
+		if (numConflicts > shared.bestConflicts || (numConflicts == shared.bestConflicts && worker >= shared.bestWorker))
+			return;
+
+		bool improved = numConflicts < shared.bestConflicts;
+		shared.bestConflicts = numConflicts;
+		shared.bestWorker = worker;
+		shared.bestColors = colors;
+
+		if (numConflicts == 0)
+			shared.solved.cancel();
+
+		if (improved && shared.onImprove)
+			shared.onImprove(numConflicts, colors);
+	}
+
+	void runWorker(portfolioShared &shared, int worker)
+	// Run worker's search to the end and publish what it finds.
+	{
+		const portfolioStrategy &strategy = strategies[worker % numStrategies];
+		long seed = streamSeed(shared.seed, worker);
+		long startSeed = streamSeed(seed, 0);
+		long searchSeed = streamSeed(seed, 1);
+		const csrGraph &g = *shared.g;
+
+		coloring colors;
+		if (strategy.start == dsaturStart)
+			dsaturColor(g, colors, shared.numColors);
+		else
+		{
+			randomNumber random(startSeed);
+			colors.resize(g.getNumNodes());
+			for (int v = 0; v < g.getNumNodes(); v++)
+				colors[v] = (unsigned short)random.random(shared.numColors);
+		}
+
+		searchControl control(shared.deadline, &shared.solved);
+		tabuColResult result;
+		int numConflicts = tabuColoring(g, colors, shared.numColors, control, searchSeed, result,
+			[&shared, worker](int numConflicts, const coloring &colors) { publish(shared, worker, numConflicts, colors); },
+			strategy.tenureRange, strategy.tenureFactor);
+
+		// The start itself may have been the worker's best
+		publish(shared, worker, numConflicts, colors);
+
+		shared.iterations += result.iterations;
+		shared.numRunning--;
+	}
+}
+
+int portfolioColoring(const csrGraph &g, coloring &colors, int numColors, int time, int numThreads, long seed)
+// Portfolio coloring on numThreads threads for at most time seconds.
+{
+	searchControl control((double)time);
+	tabuColResult result;
+	return portfolioColoring(g, colors, numColors, control, numThreads, seed, result);
+}
+
+int portfolioColoring(const csrGraph &g, coloring &colors, int numColors, const searchControl &control, int numThreads,
+	long seed, tabuColResult &result, const coloringCallback &onImprove)
+// Color g with numColors colors by numThreads TabuCol searches at once, until one has no
+// conflicts or control stops them, and leave the best coloring found in colors.  result gets the
+// iterations of all the workers together and the elapsed time.  onImprove, if set, is called
+// with each coloring better than any before, from whichever thread found it.  Returns the
+// number of conflicts of the best coloring.
+{
+	if (numColors < 1 || numColors > maxColors)
+		throw rangeError("Bad number of colors in portfolioColoring");
+	if (numThreads < 1)
+		numThreads = 1;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	portfolioShared shared;
+	shared.g = &g;
+	shared.numColors = numColors;
+	shared.seed = seed;
+	shared.deadline = control.getDeadline();
+	shared.onImprove = onImprove;
+	shared.bestConflicts = INT_MAX;
+	shared.bestWorker = numThreads;
+	shared.iterations = 0;
+	shared.numRunning = numThreads;
+
+	vector<thread> threads;
+	for (int i = 0; i < numThreads; i++)
+		threads.push_back(thread(runWorker, ref(shared), i));
+
+	// The workers watch only the deadline and each other, so pass on a cancellation of control
+	searchControl monitor = control;
+	while (shared.numRunning > 0)
+	{
+		if (monitor.checkNow())
+		{
+			shared.solved.cancel();
+			break;
+		}
+
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+
+	for (int i = 0; i < (int)threads.size(); i++)
+		threads[i].join();
+
+	colors = shared.bestColors;
+
+	result.numConflicts = shared.bestConflicts;
+	result.iterations = shared.iterations;
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	return shared.bestConflicts;
+}
@@ -0,0 +1,10 @@
+// Parallel portfolio of coloring searches
+#pragma once
+
+#include "anytime.h"
+#include "csrgraph.h"
+#include "tabucol.h"
+
+int portfolioColoring(const csrGraph &g, coloring &colors, int numColors, int time, int numThreads, long seed);
+int portfolioColoring(const csrGraph &g, coloring &colors, int numColors, const searchControl &control, int numThreads,
+	long seed, tabuColResult &result, const coloringCallback &onImprove = coloringCallback());
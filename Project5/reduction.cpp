@@ -0,0 +1,187 @@
+// File: reduction.cpp
+// Fixes knapsack variables before search with the reduction tests of Ingargiola and Korsh.
+// The lower bound is the greedy solution that fills the knapsack in density order.  An item
+// that the LP solution takes is fixed in if the LP bound with that item left out is no better
+// than the lower bound, and any other item is fixed out if the LP bound with it forced in is no
+// better.  Either way, no solution that goes the other way can beat the lower bound, so the
+// optimum is the better of the lower bound solution and the best solution of the reduced
+// instance on the items left free.  Each test is one binary search in the density order's
+// prefix sums, so the whole reduction costs O(n log n).
+
+#include <algorithm>
+
+#include "reduction.h"
+#include "searchstats.h"
+
+using namespace std;
+
+namespace
+{
+	struct lpBounds
+	{
+		const knapsack *k;
+		const vector<int> *order;
+		vector<long long> prefixCost;	// of the first i items in density order
+		vector<long long> prefixValue;
+
+		long long boundWithout(int p, long long room) const
+		// Return the integer part of the LP bound for room, with the item at position p of the
+		// density order left out (p = -1 leaves nothing out).
+		{
+			int n = k->getNumObjects();
+			int excludedCost = p < 0 ? 0 : k->getCost((*order)[p]);
+			int excludedValue = p < 0 ? 0 : k->getValue((*order)[p]);
+
+			// Largest i with the first i items, less the excluded one, fitting in room
+			int low = 0;
+			int high = n;
+			while (low < high)
+			{
+				int mid = low + (high - low + 1) / 2;
+				long long cost = prefixCost[mid] - (p >= 0 && mid > p ? excludedCost : 0);
+				if (cost <= room)
+					low = mid;
+				else
+					high = mid - 1;
+			}
+
+			bool skipped = p >= 0 && low > p;
+			long long cost = prefixCost[low] - (skipped ? excludedCost : 0);
+			long long value = prefixValue[low] - (skipped ? excludedValue : 0);
+
+			// The break item; never the excluded one, which fits wherever the items before it do
+			if (low < n && k->getCost((*order)[low]) > 0)
+			{
+				int item = (*order)[low];
+				value += (room - cost) * k->getValue(item) / k->getCost(item);
+			}
+
+			return value;
+		}
+	};
+}
+
+void reduceKnapsack(const knapsack &k, knapsackReduction &r)
+// Run the reduction tests on k, ignoring anything selected in it.
+{
+	int n = k.getNumObjects();
+	const vector<int> &order = k.sort();
+
+	lpBounds lp;
+	lp.k = &k;
+	lp.order = &order;
+	lp.prefixCost.assign(n + 1, 0);
+	lp.prefixValue.assign(n + 1, 0);
+	for (int i = 0; i < n; i++)
+	{
+		lp.prefixCost[i + 1] = lp.prefixCost[i] + k.getCost(order[i]);
+		lp.prefixValue[i + 1] = lp.prefixValue[i] + k.getValue(order[i]);
+	}
+
+	// Greedy lower bound, and the break item where the LP solution stops taking whole items
+	r.lowerBoundItems = Solution(n);
+	long long room = k.getCostLimit();
+	long long lowerBound = 0;
+	int breakItem = n;
+	for (int i = 0; i < n; i++)
+	{
+		int item = order[i];
+		if (k.getCost(item) <= room)
+		{
+			room -= k.getCost(item);
+			lowerBound += k.getValue(item);
+			r.lowerBoundItems.set(item);
+		}
+		else if (breakItem == n)
+			breakItem = i;
+	}
+	r.lowerBound = (int)lowerBound;
+
+	r.freeItems.clear();
+	r.fixedIn.clear();
+	r.numFixedOut = 0;
+	long long fixedCost = 0;
+
+	for (int p = 0; p < n; p++)
+	{
+		int item = order[p];
+
+		if (p < breakItem)
+		{
+			if (lp.boundWithout(p, k.getCostLimit()) <= lowerBound)
+			{
+				r.fixedIn.push_back(item);
+				fixedCost += k.getCost(item);
+				continue;
+			}
+		}
+		else if (k.getCost(item) > k.getCostLimit() ||
+			k.getValue(item) + lp.boundWithout(p, k.getCostLimit() - k.getCost(item)) <= lowerBound)
+		{
+			r.numFixedOut++;
+			continue;
+		}
+
+		r.freeItems.push_back(item);
+	}
+
+	std::sort(r.freeItems.begin(), r.freeItems.end());
+	std::sort(r.fixedIn.begin(), r.fixedIn.end());
+	r.reducedCostLimit = (int)(k.getCostLimit() - fixedCost);
+
+	STAT_ADD(variablesFixed, (long long)r.fixedIn.size() + r.numFixedOut);
+}
+
+knapsack reducedKnapsack(const knapsack &k, const knapsackReduction &r)
+// Return the instance on the free items of r.
+{
+	vector<int> value(r.freeItems.size());
+	vector<int> cost(r.freeItems.size());
+	for (int i = 0; i < (int)r.freeItems.size(); i++)
+	{
+		value[i] = k.getValue(r.freeItems[i]);
+		cost[i] = k.getCost(r.freeItems[i]);
+	}
+
+	return knapsack(r.reducedCostLimit, value, cost);
+}
+
+void restoreSolution(knapsack &k, const knapsackReduction &r, const knapsack &reduced)
+// Select in k the fixed items plus the items selected in reduced, or the lower bound solution
+// if that is better.
+{
+	Solution items(k.getNumObjects());
+	long long value = 0;
+
+	for (int i = 0; i < (int)r.fixedIn.size(); i++)
+	{
+		items.set(r.fixedIn[i]);
+		value += k.getValue(r.fixedIn[i]);
+	}
+
+	const Solution &chosen = reduced.getSelected();
+	for (int i = chosen.first(); i != -1; i = chosen.next(i))
+	{
+		items.set(r.freeItems[i]);
+		value += k.getValue(r.freeItems[i]);
+	}
+
+	if (value > r.lowerBound)
+		k.setItems(items);
+	else
+		k.setItems(r.lowerBoundItems);
+}
+
+int reduceAndSolve(knapsack &k, const function<void(knapsack &)> &solve)
+// Fix what variables the reduction tests can, run solve on the reduced instance, and leave the
+// combined solution in k.  Returns the number of variables fixed.
+{
+	knapsackReduction r;
+	reduceKnapsack(k, r);
+
+	knapsack reduced = reducedKnapsack(k, r);
+	solve(reduced);
+	restoreSolution(k, r, reduced);
+
+	return k.getNumObjects() - (int)r.freeItems.size();
+}
@@ -0,0 +1,23 @@
+// Variable fixing for the knapsack problem
+#pragma once
+
+#include <functional>
+
+#include "knapsack.h"
+
+// The result of fixing variables by bound tests.  The items left free form a smaller instance
+// with costLimit reduced by the cost of the items fixed in.
+struct knapsackReduction
+{
+	vector<int> freeItems;		// item numbers, in the order of the reduced instance
+	vector<int> fixedIn;		// items that every better solution than lowerBound must take
+	int numFixedOut;
+	int reducedCostLimit;
+	int lowerBound;
+	Solution lowerBoundItems;	// a solution of value lowerBound
+};
+
+void reduceKnapsack(const knapsack &k, knapsackReduction &r);
+knapsack reducedKnapsack(const knapsack &k, const knapsackReduction &r);
+void restoreSolution(knapsack &k, const knapsackReduction &r, const knapsack &reduced);
+int reduceAndSolve(knapsack &k, const function<void(knapsack &)> &solve);
@@ -0,0 +1,178 @@
+// File: searchstats.cpp
+// Thread-local search counters, summed over threads and written as JSON on request.
+
+#include "searchstats.h"
+
+#ifdef SEARCH_STATS
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+#include "d_except.h"
+
+namespace
+{
+	const char *counterNames[numStatCounters] =
+	{
+		"nodesExpanded", "prunedByBound", "prunedByFeasibility", "leavesReached", "boundCalls",
+		"boundNanoseconds", "incumbentUpdates", "iterations", "neighborsEvaluated",
+		"variablesFixed", "dominanceProbes", "dominanceHits", "dominancePrunes"
+	};
+
+	const char *gaugeNames[numStatGauges] = { "maxSearchDepth", "maxOpenNodes" };
+
+	// Longest incumbent timeline kept per thread
+	const int maxIncumbents = 100000;
+
+	struct statsRegistry
+	{
+		mutex lock;
+		vector<searchStats *> live;
+		searchStats retired;	// counts of threads that have exited since the last reset
+		chrono::steady_clock::time_point start;
+
+		statsRegistry() : start(chrono::steady_clock::now()) {}
+	};
+
+	statsRegistry &registry()
+	{
+		static statsRegistry r;
+		return r;
+	}
+
+	// A thread's counters, registered while the thread runs and folded into the retired
+	// counts when it exits
+	struct threadStats
+	{
+		searchStats stats;
+
+		threadStats()
+		{
+			statsRegistry &r = registry();
+			lock_guard<mutex> guard(r.lock);
+			r.live.push_back(&stats);
+		}
+
+		~threadStats()
+		{
+			statsRegistry &r = registry();
+			lock_guard<mutex> guard(r.lock);
+			r.retired.merge(stats);
+			r.live.erase(find(r.live.begin(), r.live.end(), &stats));
+		}
+	};
+}
+
+searchStats::searchStats()
+{
+	clear();
+}
+
+void searchStats::clear()
+{
+	for (int i = 0; i < numStatCounters; i++)
+		counters[i] = 0;
+	for (int i = 0; i < numStatGauges; i++)
+		gauges[i] = 0;
+	incumbents.clear();
+}
+
+void searchStats::merge(const searchStats &s)
+// Add the counters of s, and take the larger of each gauge.
+{
+	for (int i = 0; i < numStatCounters; i++)
+		counters[i] += s.counters[i];
+	for (int i = 0; i < numStatGauges; i++)
+		gauges[i] = max(gauges[i], s.gauges[i]);
+	incumbents.insert(incumbents.end(), s.incumbents.begin(), s.incumbents.end());
+}
+
+statTimer::statTimer(statCounter counter) : counter(counter), start(chrono::steady_clock::now())
+{
+}
+
+statTimer::~statTimer()
+{
+	localStats().counters[counter] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
+
+searchStats &localStats()
+// Return the calling thread's counters.
+{
+	thread_local threadStats local;
+	return local.stats;
+}
+
+void statsIncumbent(int value)
+// Count a new incumbent and add it to the timeline.
+{
+	searchStats &s = localStats();
+	s.counters[incumbentUpdates]++;
+
+	if ((int)s.incumbents.size() < maxIncumbents)
+	{
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - registry().start).count();
+		s.incumbents.push_back(make_pair(seconds, value));
+	}
+}
+
+void statsReset()
+// Zero every thread's counters and restart the timeline clock.  Call between runs, while no
+// search threads are counting.
+{
+	statsRegistry &r = registry();
+	lock_guard<mutex> guard(r.lock);
+
+	for (int i = 0; i < (int)r.live.size(); i++)
+		r.live[i]->clear();
+	r.retired.clear();
+	r.start = chrono::steady_clock::now();
+}
+
+void statsWrite(const string &fileName)
+// Write the counters of all threads to fileName as JSON.  The timeline keeps only the
+// incumbents that improved on every earlier one, across all threads.
+{
+	statsRegistry &r = registry();
+	searchStats total;
+	double seconds;
+	{
+		lock_guard<mutex> guard(r.lock);
+		total.merge(r.retired);
+		for (int i = 0; i < (int)r.live.size(); i++)
+			total.merge(*r.live[i]);
+		seconds = chrono::duration<double>(chrono::steady_clock::now() - r.start).count();
+	}
+
+	std::sort(total.incumbents.begin(), total.incumbents.end());
+
+	ofstream fout(fileName.c_str());
+	if (!fout)
+		throw fileOpenError(fileName);
+
+	fout << "{" << endl;
+	fout << "  \"seconds\": " << seconds << "," << endl;
+	for (int i = 0; i < numStatCounters; i++)
+		fout << "  \"" << counterNames[i] << "\": " << total.counters[i] << "," << endl;
+	for (int i = 0; i < numStatGauges; i++)
+		fout << "  \"" << gaugeNames[i] << "\": " << total.gauges[i] << "," << endl;
+
+	fout << "  \"incumbents\": [";
+	bool first = true;
+	for (int i = 0; i < (int)total.incumbents.size(); i++)
+	{
+		if (!first && total.incumbents[i].second <= total.incumbents[i - 1].second)
+		{
+			total.incumbents[i].second = total.incumbents[i - 1].second;
+			continue;
+		}
+
+		fout << (first ? "" : ",") << endl << "    { \"seconds\": " << total.incumbents[i].first
+			<< ", \"value\": " << total.incumbents[i].second << " }";
+		first = false;
+	}
+	fout << endl << "  ]" << endl << "}" << endl;
+}
+
+#endif
@@ -0,0 +1,90 @@
+// Search instrumentation counters
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Counters are compiled in only when SEARCH_STATS is defined (add it to the preprocessor
+// definitions of the project); otherwise every STAT_ and STATS_ macro expands to nothing.
+// Each thread counts into its own copy, and STATS_WRITE sums the copies of all threads,
+// including threads that have already exited.
+
+enum statCounter
+{
+	nodesExpanded,
+	prunedByBound,
+	prunedByFeasibility,
+	leavesReached,
+	boundCalls,
+	boundNanoseconds,
+	incumbentUpdates,
+	iterations,
+	neighborsEvaluated,
+	variablesFixed,
+	dominanceProbes,
+	dominanceHits,
+	dominancePrunes,
+	numStatCounters
+};
+
+enum statGauge
+{
+	maxSearchDepth,
+	maxOpenNodes,
+	numStatGauges
+};
+
+#ifdef SEARCH_STATS
+
+#include <chrono>
+
+struct searchStats
+{
+	long long counters[numStatCounters];
+	long long gauges[numStatGauges];
+	// (seconds since STATS_RESET, value).  The timeline keeps only values that rise, so a
+	// minimizing search records the negative of its objective.
+	vector<pair<double, int> > incumbents;
+
+	searchStats();
+	void clear();
+	void merge(const searchStats &s);
+};
+
+// Times its scope into a counter of nanoseconds
+class statTimer
+{
+public:
+	statTimer(statCounter counter);
+	~statTimer();
+
+private:
+	statCounter counter;
+	chrono::steady_clock::time_point start;
+};
+
+searchStats &localStats();
+void statsIncumbent(int value);
+void statsReset();
+void statsWrite(const string &fileName);
+
+#define STAT_ADD(counter, n) (localStats().counters[counter] += (n))
+#define STAT_MAX(gauge, v) do { long long v_ = (v); long long &g_ = localStats().gauges[gauge]; if (v_ > g_) g_ = v_; } while (0)
+#define STAT_TIMER(counter) statTimer statTimer_(counter)
+#define STAT_INCUMBENT(value) statsIncumbent(value)
+#define STATS_RESET() statsReset()
+#define STATS_WRITE(fileName) statsWrite(fileName)
+
+#else
+
+#define STAT_ADD(counter, n) ((void)0)
+#define STAT_MAX(gauge, v) ((void)0)
+#define STAT_TIMER(counter)
+#define STAT_INCUMBENT(value) ((void)0)
+#define STATS_RESET() ((void)0)
+#define STATS_WRITE(fileName) ((void)0)
+
+#endif
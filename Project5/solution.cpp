@@ -0,0 +1,128 @@
+#include "solution.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+int popCount(unsigned long long word)
+// Return the number of bits set in word.
+{
+#ifdef _MSC_VER
+	return (int)__popcnt64(word);
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+int lowestBit(unsigned long long word)
+// Return the index of the lowest bit set in word, which must not be zero.
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (int)index;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+Solution::Solution()
+{
+	numItems = 0;
+}
+
+Solution::Solution(int numItems)
+// Create an empty solution for items 0..numItems-1.
+{
+	this->numItems = numItems;
+	words.assign((numItems + 63) / 64, 0);
+}
+
+int Solution::size() const
+// Return the number of items the solution can hold.
+{
+	return numItems;
+}
+
+bool Solution::test(int i) const
+// Return true if item i is in the solution.
+{
+	return (words[i >> 6] >> (i & 63)) & 1;
+}
+
+void Solution::set(int i)
+{
+	words[i >> 6] |= 1ULL << (i & 63);
+}
+
+void Solution::reset(int i)
+{
+	words[i >> 6] &= ~(1ULL << (i & 63));
+}
+
+void Solution::clear()
+// Remove every item.
+{
+	for (int w = 0; w < (int)words.size(); w++)
+		words[w] = 0;
+}
+
+int Solution::count() const
+// Return the number of items in the solution.
+{
+	int total = 0;
+	for (int w = 0; w < (int)words.size(); w++)
+		total += popCount(words[w]);
+
+	return total;
+}
+
+int Solution::first() const
+// Return the lowest item in the solution, or -1 if it is empty.
+{
+	return next(-1);
+}
+
+int Solution::next(int i) const
+// Return the lowest item in the solution above i, or -1 if there is none.
+{
+	i++;
+	if (i >= numItems)
+		return -1;
+
+	int w = i >> 6;
+	unsigned long long word = words[w] & (~0ULL << (i & 63));
+
+	while (word == 0)
+	{
+		if (++w == (int)words.size())
+			return -1;
+		word = words[w];
+	}
+
+	return (w << 6) + lowestBit(word);
+}
+
+void Solution::getItems(vector<int> &items) const
+// Fill items with the items in the solution, in increasing order.
+{
+	items.clear();
+	for (int i = first(); i != -1; i = next(i))
+		items.push_back(i);
+}
+
+bool Solution::operator==(const Solution &s) const
+{
+	return numItems == s.numItems && words == s.words;
+}
+
+bool Solution::operator!=(const Solution &s) const
+{
+	return !(*this == s);
+}
+
+const vector<unsigned long long> &Solution::getWords() const
+// Return the words holding the solution.  Bits above the last item are always zero.
+{
+	return words;
+}
@@ -0,0 +1,34 @@
+// Bitset solution class
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+// A set of items stored one bit per item in 64-bit words.  Counting, comparing and copying
+// work a word at a time, so a solution for n items costs n/8 bytes.
+class Solution
+{
+public:
+	Solution();
+	Solution(int numItems);
+	int size() const;
+	bool test(int i) const;
+	void set(int i);
+	void reset(int i);
+	void clear();
+	int count() const;
+	int first() const;
+	int next(int i) const;
+	void getItems(vector<int> &items) const;
+	bool operator==(const Solution &s) const;
+	bool operator!=(const Solution &s) const;
+	const vector<unsigned long long> &getWords() const;
+
+private:
+	int numItems;
+	vector<unsigned long long> words;
+};
+
+int popCount(unsigned long long word);
+int lowestBit(unsigned long long word);
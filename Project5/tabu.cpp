@@ -0,0 +1,83 @@
+#include "tabu.h"
+
+tabuList::tabuList(int numItems, int capacity, int tenure)
+// Create an empty list for items 0..numItems-1 that can hold up to capacity entries.
+{
+	ring.assign(capacity > 0 ? capacity : 1, -1);
+	count.assign(numItems, 0);
+	head = 0;
+	size = 0;
+	this->tenure = 0;
+	setTenure(tenure);
+}
+
+bool tabuList::isTabu(int item) const
+// Return true if item has been moved within the last tenure entries.
+{
+	return count[item] > 0;
+}
+
+void tabuList::add(int item)
+// Record a move of item, dropping the oldest entry if the list is at its tenure.
+// An item of -1 records an iteration without a move, so that older entries still age.
+{
+	if (tenure == 0)
+		return;
+
+	if (size == tenure)
+		removeOldest();
+
+	ring[(head + size) % ring.size()] = item;
+	size++;
+
+	if (item != -1)
+		count[item]++;
+}
+
+int tabuList::getTenure() const
+{
+	return tenure;
+}
+
+void tabuList::setTenure(int tenure)
+// Change the tenure, forgetting the oldest entries if it shrinks.
+{
+	if (tenure < 0)
+		tenure = 0;
+	if (tenure > (int)ring.size())
+		tenure = (int)ring.size();
+
+	this->tenure = tenure;
+	while (size > tenure)
+		removeOldest();
+}
+
+void tabuList::removeOldest()
+{
+	int item = ring[head];
+	if (item != -1)
+		count[item]--;
+
+	head = (head + 1) % ring.size();
+	size--;
+}
+
+visitedTable::visitedTable(int logSize)
+// Create an empty table of 2^logSize slots, at least two.
+{
+	if (logSize < 1)
+		logSize = 1;
+
+	slots.assign((size_t)1 << logSize, 0);
+	mask = ((unsigned long long)1 << logSize) - 1;
+}
+
+bool visitedTable::visit(unsigned long long hash)
+// Record hash and return true if it was already in the table.
+{
+	unsigned long long &slot = slots[hash & mask];
+	bool seen = slot == (hash | 1);
+
+	slot = hash | 1;
+	return seen;
+}
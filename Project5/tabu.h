@@ -0,0 +1,42 @@
+// Tabu list and visited-solution table for local search
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+// Fixed-size ring buffer of recently moved items.  An item is tabu while it is among the
+// last tenure entries; a count per item makes the test O(1).  The tenure may be changed
+// at any time up to the capacity given at construction.
+class tabuList
+{
+public:
+	tabuList(int numItems, int capacity, int tenure);
+	bool isTabu(int item) const;
+	void add(int item);
+	int getTenure() const;
+	void setTenure(int tenure);
+
+private:
+	vector<int> ring;
+	vector<int> count;
+	int head;
+	int size;
+	int tenure;
+
+	void removeOldest();
+};
+
+// Lossy table of solution hashes seen recently, used to detect when a search cycles.
+// Each hash maps to one slot, and a newer hash simply overwrites an older one.  The low bit of
+// a hash is implied by its slot, so a slot holds its hash with that bit set and 0 marks it empty.
+class visitedTable
+{
+public:
+	visitedTable(int logSize);
+	bool visit(unsigned long long hash);
+
+private:
+	vector<unsigned long long> slots;
+	unsigned long long mask;
+};
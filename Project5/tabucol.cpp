@@ -0,0 +1,116 @@
+// File: tabucol.cpp
+// TabuCol, the tabu search for graph coloring of Hertz and de Werra as tuned by Galinier and Hao.
+// Every iteration makes the best recolor of a node in conflict, scored in O(1) from a
+// conflictTable, with ties broken at random.  Giving node v back a color it just left is tabu for
+// a random 0..tenureRange-1 iterations plus tenureFactor times the number of nodes in conflict
+// (10 and 0.6 by default), so the tenure grows while the search is far from a proper coloring and
+// shrinks as it closes in.  A tabu move is still allowed if it would beat the best coloring found
+// (aspiration), and if every move is tabu a random node in conflict takes a random color.
+
+#include <algorithm>
+#include <chrono>
+#include <limits.h>
+
+#include "conflicttable.h"
+#include "d_random.h"
+#include "searchstats.h"
+#include "tabucol.h"
+
+using namespace std;
+
+double tabuColResult::iterationsPerSecond() const
+// Return the iterations run per second of the run.
+{
+	return seconds > 0 ? iterations / seconds : 0;
+}
+
+int tabuColoring(const csrGraph &g, coloring &colors, int numColors, searchControl &control, long seed,
+	tabuColResult &result, const coloringCallback &onImprove, int tenureRange, double tenureFactor)
+// Search from the coloring in colors until there are no conflicts or control stops the search,
+// and leave the best coloring found in colors.  onImprove, if set, is called with each coloring
+// better than any before.  Returns the number of conflicts of the best coloring.  The search
+// depends only on its arguments and seed, up to where control stops it.
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	conflictTable t(g, numColors);
+	t.reset(colors);
+
+	randomNumber random(seed);
+	vector<long long> tabuUntil((size_t)g.getNumNodes() * numColors, 0);
+	int bestConflicts = t.getNumConflicts();
+	long long iteration = 0;
+
+	while (t.getNumConflicts() > 0 && numColors > 1 && !control.stopped())
+	{
+		iteration++;
+
+		int bestDelta = INT_MAX;
+		int moveNode = -1;
+		int moveColor = -1;
+		int ties = 0;
+
+		for (int i = 0; i < t.getNumConflicting(); i++)
+		{
+			int v = t.getConflicting(i);
+			const long long *tabuRow = &tabuUntil[(size_t)v * numColors];
+
+			for (int color = 0; color < numColors; color++)
+			{
+				if (color == t.getColor(v))
+					continue;
+
+				int d = t.delta(v, color);
+				if (d > bestDelta)
+					continue;
+
+				if (tabuRow[color] >= iteration && t.getNumConflicts() + d >= bestConflicts)
+					continue;
+
+				if (d < bestDelta)
+				{
+					bestDelta = d;
+					ties = 0;
+				}
+
+				// Keep each of the tied moves with equal probability
+				if (random.random(++ties) == 0)
+				{
+					moveNode = v;
+					moveColor = color;
+				}
+			}
+		}
+
+		STAT_ADD(neighborsEvaluated, (long long)t.getNumConflicting() * (numColors - 1));
+
+		if (moveNode < 0)
+		{
+			moveNode = t.getConflicting((int)random.random(t.getNumConflicting()));
+			moveColor = (t.getColor(moveNode) + 1 + (int)random.random(numColors - 1)) % numColors;
+		}
+
+		int oldColor = t.getColor(moveNode);
+		t.recolor(moveNode, moveColor);
+		tabuUntil[(size_t)moveNode * numColors + oldColor] = iteration + random.random(max(tenureRange, 1)) +
+			(long long)(tenureFactor * t.getNumConflicting());
+
+		if (t.getNumConflicts() < bestConflicts)
+		{
+			bestConflicts = t.getNumConflicts();
+			colors = t.getColors();
+			STAT_INCUMBENT(-bestConflicts);
+
+			if (onImprove)
+				onImprove(bestConflicts, colors);
+		}
+	}
+
+	STAT_ADD(iterations, iteration);
+
+	result.numConflicts = bestConflicts;
+	result.iterations = iteration;
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	return bestConflicts;
+}
@@ -0,0 +1,19 @@
+// TabuCol local search for graph coloring
+#pragma once
+
+#include "anytime.h"
+#include "csrgraph.h"
+
+// What a TabuCol run did
+struct tabuColResult
+{
+	int numConflicts;		// of the best coloring found
+	long long iterations;
+	double seconds;
+
+	double iterationsPerSecond() const;
+};
+
+int tabuColoring(const csrGraph &g, coloring &colors, int numColors, searchControl &control, long seed,
+	tabuColResult &result, const coloringCallback &onImprove = coloringCallback(),
+	int tenureRange = 10, double tenureFactor = 0.6);